@@ -0,0 +1,330 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <AnnotationIndex.h>
+#include <AtomicFile.h>
+#include <IntervalFactory.h>
+#include <FS.h>
+#include <JSON.h>
+#include <format.h>
+#include <timew.h>
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <memory>
+#include <set>
+#include <sstream>
+
+////////////////////////////////////////////////////////////////////////////////
+// Split an annotation into lower case words. Surrounding punctuation is not
+// part of a word, but inner punctuation is, so that 'ABC-123,' and 'v1.2'
+// become 'abc-123' and 'v1.2'. The words are returned sorted and unique.
+std::vector <std::string> AnnotationIndex::tokenize (const std::string& text)
+{
+  static const std::string punctuation = "\"'`()[]{}<>,;:.!?";
+
+  std::set <std::string> words;
+  std::string::size_type i = 0;
+  while (i < text.length ())
+  {
+    while (i < text.length () && isspace (static_cast <unsigned char> (text[i])))
+      ++i;
+
+    auto start = i;
+    while (i < text.length () && ! isspace (static_cast <unsigned char> (text[i])))
+      ++i;
+
+    auto word = text.substr (start, i - start);
+    auto first = word.find_first_not_of (punctuation);
+    if (first == std::string::npos)
+      continue;
+
+    word = word.substr (first, word.find_last_not_of (punctuation) - first + 1);
+    std::transform (word.begin (), word.end (), word.begin (),
+                    [] (unsigned char c) { return std::tolower (c); });
+    words.insert (word);
+  }
+
+  return std::vector <std::string> (words.begin (), words.end ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Load the index file, if there is one. A missing or unreadable index is not an
+// error, as every month will then be found stale and indexed on demand.
+void AnnotationIndex::initialize (const std::string& location)
+{
+  _location = location;
+  _months.clear ();
+  _modified = false;
+
+  std::string content;
+  Path path (_location);
+  if (! path.exists () || ! File::read (path, content) || content.empty ())
+    return;
+
+  try
+  {
+    std::unique_ptr <json::object> json (dynamic_cast <json::object*> (json::parse (content)));
+    if (json == nullptr)
+      throw std::string ("Contents invalid.");
+
+    for (auto& month : json->_data)
+    {
+      auto object = dynamic_cast <json::object*> (month.second);
+      if (object == nullptr)
+        throw std::string ("Contents invalid.");
+
+      auto checksum = dynamic_cast <json::string*> (object->_data["checksum"]);
+      auto lines    = dynamic_cast <json::number*> (object->_data["lines"]);
+      auto words    = dynamic_cast <json::object*> (object->_data["words"]);
+      if (checksum == nullptr || lines == nullptr || words == nullptr)
+        throw format ("Incomplete entry for '{1}'.", month.first);
+
+      Month entry {json::decode (checksum->_data),
+                   static_cast <unsigned int> (lines->_dvalue),
+                   {}};
+
+      for (auto& word : words->_data)
+      {
+        auto positions = dynamic_cast <json::array*> (word.second);
+        if (positions == nullptr)
+          throw format ("Invalid postings for '{1}'.", word.first);
+
+        auto& posting = entry.postings[json::decode (word.first)];
+        for (auto& position : positions->_data)
+          posting.push_back (static_cast <unsigned int> (dynamic_cast <json::number*> (position)->_dvalue));
+      }
+
+      _months[json::decode (month.first)] = entry;
+    }
+  }
+
+  catch (const std::string& error)
+  {
+    debug (format ("Ignoring annotation index {1}: {2}", _location, error));
+    _months.clear ();
+    _modified = true;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AnnotationIndex::commit ()
+{
+  if (_modified)
+  {
+    AtomicFile::write (_location, toJson ());
+    _modified = false;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A month is fresh if it is indexed, and the data file still has the checksum
+// it had when it was indexed.
+bool AnnotationIndex::fresh (const std::string& month, const std::string& checksum) const
+{
+  auto found = _months.find (month);
+  return found != _months.end () && found->second.checksum == checksum;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// (Re)build the postings of one month from its lines, which must be in the
+// order they are stored in, and the checksum of the file they were read from.
+void AnnotationIndex::index (
+  const std::string& month,
+  const std::vector <std::string>& lines,
+  const std::string& checksum)
+{
+  Month entry {checksum, static_cast <unsigned int> (lines.size ()), {}};
+
+  for (unsigned int i = 0; i < lines.size (); ++i)
+  {
+    // Only lines with an annotation need to be parsed.
+    if (lines[i].find ('"') == std::string::npos)
+      continue;
+
+    auto interval = IntervalFactory::fromSerialization (lines[i]);
+    for (auto& word : tokenize (interval.getAnnotation ()))
+      entry.postings[word].push_back (i);
+  }
+
+  _months[month] = entry;
+  _modified = true;
+  debug (format ("Indexed annotations of {1}: {2} words", month, entry.postings.size ()));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A line with the annotation was added to a fresh month, at position in the
+// sorted file. The lines after it move down by one.
+void AnnotationIndex::insert (
+  const std::string& month,
+  unsigned int position,
+  const std::string& annotation)
+{
+  auto& entry = _months[month];
+  for (auto& posting : entry.postings)
+    for (auto& line : posting.second)
+      if (line >= position)
+        ++line;
+
+  for (auto& word : tokenize (annotation))
+  {
+    auto& posting = entry.postings[word];
+    posting.insert (std::lower_bound (posting.begin (), posting.end (), position), position);
+  }
+
+  ++entry.lines;
+  _modified = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The line at position in the sorted file was deleted from a fresh month. The
+// lines after it move up by one.
+void AnnotationIndex::erase (const std::string& month, unsigned int position)
+{
+  auto& entry = _months[month];
+  for (auto posting = entry.postings.begin (); posting != entry.postings.end (); )
+  {
+    auto& lines = posting->second;
+    lines.erase (std::remove (lines.begin (), lines.end (), position), lines.end ());
+    for (auto& line : lines)
+      if (line > position)
+        --line;
+
+    if (lines.empty ())
+      posting = entry.postings.erase (posting);
+    else
+      ++posting;
+  }
+
+  if (entry.lines)
+    --entry.lines;
+
+  _modified = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The lines inserted and erased were written, as a file with the checksum.
+void AnnotationIndex::written (const std::string& month, const std::string& checksum)
+{
+  _months[month].checksum = checksum;
+  _modified = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AnnotationIndex::remove (const std::string& month)
+{
+  if (_months.erase (month))
+    _modified = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned int AnnotationIndex::lines (const std::string& month) const
+{
+  auto found = _months.find (month);
+  return found == _months.end () ? 0 : found->second.lines;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Positions of the lines in month whose annotation contains all the words, in
+// ascending order.
+std::vector <unsigned int> AnnotationIndex::find (
+  const std::string& month,
+  const std::vector <std::string>& words) const
+{
+  std::vector <unsigned int> result;
+
+  auto found = _months.find (month);
+  if (found == _months.end () || words.empty ())
+    return result;
+
+  auto& postings = found->second.postings;
+  for (unsigned int i = 0; i < words.size (); ++i)
+  {
+    auto posting = postings.find (words[i]);
+    if (posting == postings.end ())
+      return {};
+
+    if (i == 0)
+    {
+      result = posting->second;
+    }
+    else
+    {
+      std::vector <unsigned int> both;
+      std::set_intersection (result.begin (), result.end (),
+                             posting->second.begin (), posting->second.end (),
+                             std::back_inserter (both));
+      result.swap (both);
+    }
+  }
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string AnnotationIndex::toJson () const
+{
+  std::stringstream json;
+  json << '{';
+
+  bool firstMonth = true;
+  for (auto& month : _months)
+  {
+    json << (firstMonth ? "" : ",")
+         << "\n  \"" << json::encode (month.first) << "\":"
+         << "{\"checksum\":\"" << json::encode (month.second.checksum) << '"'
+         << ",\"lines\":" << month.second.lines
+         << ",\"words\":{";
+
+    bool firstWord = true;
+    for (auto& posting : month.second.postings)
+    {
+      json << (firstWord ? "" : ",")
+           << '"' << json::encode (posting.first) << "\":[";
+
+      for (unsigned int i = 0; i < posting.second.size (); ++i)
+        json << (i ? "," : "") << posting.second[i];
+
+      json << ']';
+      firstWord = false;
+    }
+
+    json << "}}";
+    firstMonth = false;
+  }
+
+  json << "\n}";
+  return json.str ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool AnnotationIndex::is_modified () const
+{
+  return _modified;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_ANNOTATIONINDEX
+#define INCLUDED_ANNOTATIONINDEX
+
+#include <map>
+#include <string>
+#include <vector>
+
+// An inverted index from annotation words to the lines of the data files that
+// contain them. Postings are kept per data file as line positions within the
+// sorted file, together with the line count and checksum of that file, so
+// that a stale month can be detected without reading it. Lines added to or
+// deleted from a month that is up to date only shift its postings.
+class AnnotationIndex
+{
+public:
+  static std::vector <std::string> tokenize (const std::string&);
+
+  void initialize (const std::string&);
+  void commit ();
+
+  bool fresh (const std::string&, const std::string&) const;
+  void index (const std::string&, const std::vector <std::string>&, const std::string&);
+  void insert (const std::string&, unsigned int, const std::string&);
+  void erase (const std::string&, unsigned int);
+  void written (const std::string&, const std::string&);
+  void remove (const std::string&);
+
+  unsigned int lines (const std::string&) const;
+  std::vector <unsigned int> find (const std::string&, const std::vector <std::string>&) const;
+
+  std::string toJson () const;
+  bool is_modified () const;
+
+private:
+  struct Month
+  {
+    std::string  checksum;
+    unsigned int lines;
+    std::map <std::string, std::vector <unsigned int>> postings;
+  };
+
+  std::string                    _location {};
+  std::map <std::string, Month>  _months   {};
+  bool                           _modified {false};
+};
+
+#endif
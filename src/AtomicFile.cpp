@@ -24,14 +24,20 @@
 //
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <csignal>
 #include <stdio.h>
 #include <string.h>
 #include <errno.h>
 #include <cassert>
 #include <iostream>
+#include <sstream>
+#include <set>
+#include <tuple>
+#include <atomic>
 #include <vector>
 #include <unistd.h>
+#include <fcntl.h>
 #include <timew.h>
 
 #include <format.h>
@@ -52,6 +58,16 @@ struct AtomicFile::impl
   // the temp file until finalization.
   bool is_temp_active {false};
 
+  // While the temp file is the real file with content appended, only that
+  // content needs to be logged.
+  bool is_append_only {false};
+  size_t original_size {0};
+  std::string appended {};
+
+  // The stamp the real file must still have when it is replaced.
+  bool has_expected {false};
+  std::string expected {};
+
   impl (const Path& path);
   ~impl ();
 
@@ -60,39 +76,73 @@ struct AtomicFile::impl
   bool exists () const;
 
   bool open ();
-  void close ();
+  void close (bool durable = false);
   size_t size () const;
   void truncate ();
   void remove ();
   void read (std::string& content);
   void read (std::vector <std::string>& lines);
+  void read (std::string& content, size_t offset);
   void append (const std::string& content);
   void write_raw (const std::string& content);
+  void replace_tail (size_t offset, const std::string& content);
 
   void finalize ();
+  std::string wal_record ();
+
+  static bool copy_prefix (const std::string& from, const std::string& to, size_t length);
+  static void sync (const std::string& path);
+  static void write_wal (const std::string& path, const std::string& content);
+  static void apply_wal_record (const std::string& op, size_t offset, const std::string& path, const std::string& data);
 
   static atomic_files_t::iterator find (const std::string& path) = delete;
   static atomic_files_t::iterator find (const Path& path);
 
-  // Static members
-
-  // If there is a problem writing to any of the temporary files, we do not want
-  // any of them to be copied over the "real" file.
-  static bool allow_atomics;
-  static atomic_files_t atomic_files;
+  // The changes of the current run or Session.
+  static Changes& changes ();
 };
 
 using atomic_files_t = AtomicFile::impl::atomic_files_t;
 using atomics_iterator = atomic_files_t::iterator;
 
-atomic_files_t AtomicFile::impl::atomic_files {};
-bool AtomicFile::impl::allow_atomics {true};
+// The changes made current on this thread by a Scope.
+static thread_local AtomicFile::Changes* active {nullptr};
+
+////////////////////////////////////////////////////////////////////////////////
+AtomicFile::Changes::Changes () = default;
+AtomicFile::Changes::~Changes () = default;
+
+////////////////////////////////////////////////////////////////////////////////
+AtomicFile::Scope::Scope (Changes& changes)
+: _previous (active)
+{
+  active = &changes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+AtomicFile::Scope::~Scope ()
+{
+  active = _previous;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Outside of any scope, as for the command line, the thread has its own.
+AtomicFile::Changes& AtomicFile::impl::changes ()
+{
+  if (active == nullptr)
+  {
+    static thread_local Changes fallback;
+    return fallback;
+  }
+
+  return *active;
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 AtomicFile::impl::impl (const Path& path)
 {
   static pid_t s_pid = ::getpid ();
-  static int s_count = 0;
+  static std::atomic <int> s_count {0};
   std::stringstream str; 
 
   str << path._data << '.' << s_pid << '-' << ++s_count << ".tmp";
@@ -140,16 +190,23 @@ bool AtomicFile::impl::open ()
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void AtomicFile::impl::close ()
+// A durable close also syncs the temp file, which must be on disk before it
+// replaces the real file. Other closes do not, as the file may still change.
+void AtomicFile::impl::close (bool durable)
 {
   try
   {
     temp_file.close ();
     real_file.close ();
+
+    if (durable && is_temp_active && temp_file.exists ())
+    {
+      sync (temp_file._data);
+    }
   }
   catch (...)
   {
-    allow_atomics = false;
+    changes ()._allowed = false;
     throw;
   }
 }
@@ -173,10 +230,11 @@ void AtomicFile::impl::truncate ()
   {
     temp_file.truncate ();
     is_temp_active = true;
+    is_append_only = false;
   }
   catch (...)
   {
-    allow_atomics = false;
+    changes ()._allowed = false;
     throw;
   }
 }
@@ -188,10 +246,11 @@ void AtomicFile::impl::remove ()
   {
     temp_file.remove ();
     is_temp_active = true;
+    is_append_only = false;
   }
   catch (...)
   {
-    allow_atomics = false;
+    changes ()._allowed = false;
     throw;
   }
 }
@@ -220,6 +279,39 @@ void AtomicFile::impl::read (std::vector <std::string>& lines)
                             real_file.read (lines);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Read the contents from offset on.
+void AtomicFile::impl::read (std::string& content, size_t offset)
+{
+  if (is_temp_active)
+  {
+    // Close the file before reading it in order to flush any buffers.
+    temp_file.close ();
+  }
+
+  content.clear ();
+  const auto& path = is_temp_active ? temp_file._data : real_file._data;
+  int fd = ::open (path.c_str (), O_RDONLY);
+  if (fd == -1)
+  {
+    return;
+  }
+
+  char buffer[65536];
+  ssize_t count;
+  while ((count = ::pread (fd, buffer, sizeof (buffer), offset)) > 0)
+  {
+    content.append (buffer, count);
+    offset += count;
+  }
+
+  ::close (fd);
+  if (count < 0)
+  {
+    throw format ("Could not read '{1}': {2}", path, strerror (errno));
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void AtomicFile::impl::append (const std::string& content)
 {
@@ -234,12 +326,22 @@ void AtomicFile::impl::append (const std::string& content)
         throw format ("Failed to copy '{1}' to '{2}'",
                       real_file.name (), temp_file.name ());
       }
+
+      is_append_only = true;
+      original_size = real_file.exists () ? real_file.size () : 0;
+      appended.clear ();
+    }
+
+    if (is_append_only)
+    {
+      appended += content;
     }
+
     return temp_file.append (content);
   }
   catch (...)
   {
-    allow_atomics = false;
+    changes ()._allowed = false;
     throw;
   }
 }
@@ -251,10 +353,50 @@ void AtomicFile::impl::write_raw (const std::string& content)
   {
     temp_file.write_raw (content);
     is_temp_active = true;
+    is_append_only = false;
+  }
+  catch (...)
+  {
+    changes ()._allowed = false;
+    throw;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Keep the first offset bytes of the file, and replace the rest by content.
+// Only those bytes are copied to the temp file, and only the new content is
+// logged, as for appending. The file must not have changed since offset was
+// taken from it.
+void AtomicFile::impl::replace_tail (size_t offset, const std::string& content)
+{
+  if (is_temp_active || ! real_file.exists ())
+  {
+    std::string current;
+    read (current);
+    truncate ();
+    write_raw (current.substr (0, offset) + content);
+    return;
+  }
+
+  try
+  {
+    if (real_file.size () < offset ||
+        ! copy_prefix (real_file._data, temp_file._data, offset))
+    {
+      throw format ("Failed to copy '{1}' to '{2}'",
+                    real_file.name (), temp_file.name ());
+    }
+
+    is_temp_active = true;
+    is_append_only = true;
+    original_size = offset;
+    appended = content;
+
+    temp_file.append (content);
   }
   catch (...)
   {
-    allow_atomics = false;
+    changes ()._allowed = false;
     throw;
   }
 }
@@ -262,7 +404,7 @@ void AtomicFile::impl::write_raw (const std::string& content)
 ////////////////////////////////////////////////////////////////////////////////
 void AtomicFile::impl::finalize ()
 {
-  if (is_temp_active && impl::allow_atomics)
+  if (is_temp_active && impl::changes ()._allowed)
   {
     if (temp_file.exists ())
     {
@@ -279,18 +421,177 @@ void AtomicFile::impl::finalize ()
       std::remove (real_file._data.c_str ());
     }
     is_temp_active = false;
+    is_append_only = false;
+    appended.clear ();
+    has_expected = false;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The log record of what finalize will do to the real file:
+//
+//   write <offset> <length> <path>\n<data>   Contents from offset on are data
+//   remove 0 0 <path>\n                      The file is removed
+//
+std::string AtomicFile::impl::wal_record ()
+{
+  if (! is_temp_active)
+  {
+    return "";
+  }
+
+  if (! temp_file.exists ())
+  {
+    return format ("remove 0 0 {1}\n", real_file._data);
+  }
+
+  if (is_append_only)
+  {
+    return format ("write {1} {2} {3}\n", original_size, appended.size (), real_file._data) + appended;
+  }
+
+  std::string content;
+  temp_file.read (content);
+  return format ("write 0 {1} {2}\n", content.size (), real_file._data) + content;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Copy the first length bytes of a file.
+bool AtomicFile::impl::copy_prefix (const std::string& from, const std::string& to, size_t length)
+{
+  int in = ::open (from.c_str (), O_RDONLY);
+  if (in == -1)
+  {
+    return false;
+  }
+
+  int out = ::open (to.c_str (), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+  if (out == -1)
+  {
+    ::close (in);
+    return false;
+  }
+
+  char buffer[65536];
+  size_t copied = 0;
+  while (copied < length)
+  {
+    auto count = ::read (in, buffer, std::min (sizeof (buffer), length - copied));
+    if (count <= 0 ||
+        ::write (out, buffer, count) != count)
+    {
+      break;
+    }
+
+    copied += count;
+  }
+
+  ::close (in);
+  return ::close (out) == 0 && copied == length;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Flush a file, or the entries of a directory, to disk.
+void AtomicFile::impl::sync (const std::string& path)
+{
+  int fd = ::open (path.c_str (), O_RDONLY);
+  if (fd == -1)
+  {
+    throw format ("Could not open '{1}': {2}", path, strerror (errno));
+  }
+
+  if (::fsync (fd) != 0)
+  {
+    ::close (fd);
+    throw format ("Could not sync '{1}': {2}", path, strerror (errno));
+  }
+
+  ::close (fd);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void AtomicFile::impl::write_wal (const std::string& wal_path, const std::string& content)
+{
+  int fd = ::open (wal_path.c_str (), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+  if (fd == -1)
+  {
+    throw format ("Could not write to '{1}': {2}", wal_path, strerror (errno));
+  }
+
+  size_t written = 0;
+  while (written < content.size ())
+  {
+    auto count = ::write (fd, content.data () + written, content.size () - written);
+    if (count < 0)
+    {
+      ::close (fd);
+      throw format ("Could not write to '{1}': {2}", wal_path, strerror (errno));
+    }
+
+    written += count;
+  }
+
+  if (::fsync (fd) != 0)
+  {
+    ::close (fd);
+    throw format ("Could not sync '{1}': {2}", wal_path, strerror (errno));
+  }
+
+  ::close (fd);
+
+  // The directory entry of the log must be durable as well.
+  sync (Path (wal_path).parent ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Applying a record twice has the same effect as applying it once. A record
+// with an offset needs a file of at least that size, see replay_wal.
+void AtomicFile::impl::apply_wal_record (
+  const std::string& op,
+  size_t offset,
+  const std::string& path,
+  const std::string& data)
+{
+  if (op == "remove")
+  {
+    debug (format ("Replaying: removing '{1}'", path));
+    std::remove (path.c_str ());
+    return;
+  }
+
+  debug (format ("Replaying: writing '{1}' from {2}", path, offset));
+
+  std::string content;
+  if (offset)
+  {
+    File::read (path, content);
+    content = content.substr (0, offset);
+  }
+
+  content += data;
+
+  auto temp = path + ".wal.tmp";
+  if (! File::write (temp, content))
+  {
+    throw format ("Could not replay changes to '{1}'. Database corruption possible.", path);
+  }
+
+  sync (temp);
+  if (std::rename (temp.c_str (), path.c_str ()))
+  {
+    throw format ("Could not replay changes to '{1}'. Database corruption possible.", path);
   }
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 atomics_iterator AtomicFile::impl::find (const Path& path)
 {
-  auto end = impl::atomic_files.end ();
+  auto end = impl::changes ()._files.end ();
   auto cmp = [&path](const atomic_files_t::value_type& p)
              {
                return p->real_file == path;
              };
-  auto it = std::find_if(impl::atomic_files.begin (), end, cmp);
+  auto it = std::find_if(impl::changes ()._files.begin (), end, cmp);
   return (it == end) ? end : it;
 }
 
@@ -300,10 +601,10 @@ AtomicFile::AtomicFile (const Path& path)
 {
   auto it = impl::find (path);
 
-  if (it == impl::atomic_files.end ())
+  if (it == impl::changes ()._files.end ())
   {
     pimpl = std::make_shared <impl> (path._data);
-    impl::atomic_files.push_back (pimpl);
+    impl::changes ()._files.push_back (pimpl);
   }
   else
   {
@@ -391,6 +692,12 @@ void AtomicFile::read (std::vector <std::string>& lines)
   pimpl->read (lines);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void AtomicFile::read (std::string& content, size_t offset)
+{
+  pimpl->read (content, offset);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void AtomicFile::append (const std::string& content)
 {
@@ -403,6 +710,21 @@ void AtomicFile::write_raw (const std::string& content)
   pimpl->write_raw (content);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void AtomicFile::replace_tail (size_t offset, const std::string& content)
+{
+  pimpl->replace_tail (offset, content);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The file is only replaced if it still has the stamp, see fileStamp, so that
+// the changes of another process since it was read are not lost.
+void AtomicFile::expect (const std::string& stamp)
+{
+  pimpl->has_expected = true;
+  pimpl->expected = stamp;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void AtomicFile::append (const std::string& path, const std::string& data)
 {
@@ -453,38 +775,115 @@ void AtomicFile::read (const Path& path, std::vector <std::string>& lines)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// finalize_all - Close / Flush all temporary files and rename to final.
-void AtomicFile::finalize_all ()
+// pending - Whether finalize_all would replace any file.
+bool AtomicFile::pending ()
 {
-  if (!impl::allow_atomics)
+  for (auto& file : impl::changes ()._files)
+  {
+    if (file->is_temp_active)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// verify - Throw if a file to be replaced changed since it was expected not
+// to. No file is replaced after that.
+void AtomicFile::verify ()
+{
+  for (auto& file : impl::changes ()._files)
+  {
+    if (file->is_temp_active &&
+        file->has_expected &&
+        fileStamp (file->path ()) != file->expected)
+    {
+      impl::changes ()._allowed = false;
+      throw format ("'{1}' was changed by another process. No changes were written.", file->path ());
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// finalize_all - Close / Flush all temporary files and rename to final. With a
+// write-ahead log, all changes are recorded there before the first file is
+// replaced, and the log is removed once the replaced files are durable.
+//
+// The log does not make the syncs of the temp files unnecessary: a record of
+// appended bytes is replayed onto the file already in place, so its first
+// bytes must be on disk before the file replaces the old one.
+void AtomicFile::finalize_all (const std::string& wal_path)
+{
+  if (!impl::changes ()._allowed)
   {
     throw std::string {"Unable to update database."};
   }
 
-  // Step 1: Close / Flush all the atomic files that may still be open. If any
-  // of the files fail this step (close () will throw) then we do not want to
-  // move on to step 2
-  for (auto& file : impl::atomic_files)
+  verify ();
+
+  // Step 1: Close / Flush / Sync all the atomic files that may still be open.
+  // If any of the files fail this step (close () will throw) then we do not
+  // want to move on to step 2
+  for (auto& file : impl::changes ()._files)
   {
-    file->close ();
+    file->close (true);
   }
 
 
+  // Step 2: Record all changes in the write-ahead log, so that if the renames
+  // below are interrupted, they are completed on the next run.
+  std::string wal;
+  if (! wal_path.empty ())
+  {
+    for (auto& file : impl::changes ()._files)
+    {
+      wal += file->wal_record ();
+    }
+
+    if (! wal.empty ())
+    {
+      impl::write_wal (wal_path, "timew-wal 1\n" + wal + "end\n");
+    }
+  }
+
+  std::set <std::string> directories;
+  for (auto& file : impl::changes ()._files)
+  {
+    if (file->is_temp_active)
+    {
+      auto directory = Path (file->path ()).parent ();
+      directories.insert (directory.empty () ? "." : directory);
+    }
+  }
+
   sigset_t new_mask;
   sigset_t old_mask;
   sigfillset (&new_mask);
 
-  // Step 2: Rename the temp files to the *real* file
+  // Step 3: Rename the temp files to the *real* file
   sigprocmask (SIG_SETMASK, &new_mask, &old_mask);
-  for (auto& file : impl::atomic_files)
+  for (auto& file : impl::changes ()._files)
   {
     file->finalize ();
   }
   sigprocmask (SIG_SETMASK, &old_mask, nullptr);
 
-  // Step 3: Cleanup any references
+  // Step 4: Make the renames durable, after which the log is no longer needed.
+  for (auto& directory : directories)
+  {
+    impl::sync (directory);
+  }
+
+  if (! wal.empty ())
+  {
+    std::remove (wal_path.c_str ());
+  }
+
+  // Step 5: Cleanup any references
   atomic_files_t new_atomic_files;
-  for (auto& file : impl::atomic_files)
+  for (auto& file : impl::changes ()._files)
   {
     // Delete entry if we are holding the last reference
     if (file.use_count () > 1)
@@ -493,13 +892,88 @@ void AtomicFile::finalize_all ()
     }
   }
 
-  new_atomic_files.swap(impl::atomic_files);
+  new_atomic_files.swap(impl::changes ()._files);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// replay_wal - Complete the changes of an interrupted finalize_all, returning
+// whether there were any. A log that was not completely written is discarded,
+// because no file was replaced yet.
+bool AtomicFile::replay_wal (const std::string& path)
+{
+  std::string content;
+  if (! File::read (path, content))
+  {
+    return false;
+  }
+
+  const std::string header {"timew-wal 1\n"};
+  const std::string trailer {"end\n"};
+  if (content.compare (0, header.size (), header) != 0 ||
+      content.size () < header.size () + trailer.size () ||
+      content.compare (content.size () - trailer.size (), trailer.size (), trailer) != 0)
+  {
+    debug (format ("Discarding incomplete '{1}'", path));
+    std::remove (path.c_str ());
+    return false;
+  }
+
+  // Parse all records before applying any.
+  std::vector <std::tuple <std::string, size_t, std::string, std::string>> records;
+  auto position = header.size ();
+  auto end = content.size () - trailer.size ();
+  while (position < end)
+  {
+    auto eol = content.find ('\n', position);
+    if (eol == std::string::npos || eol > end)
+    {
+      throw format ("Malformed '{1}'. Database corruption possible.", path);
+    }
+
+    std::istringstream line (content.substr (position, eol - position));
+    std::string op;
+    size_t offset;
+    size_t length;
+    line >> op >> offset >> length;
+    line.get ();
+    std::string file;
+    std::getline (line, file);
+
+    if ((op != "write" && op != "remove") || file.empty () || eol + 1 + length > end)
+    {
+      throw format ("Malformed '{1}'. Database corruption possible.", path);
+    }
+
+    records.emplace_back (op, offset, file, content.substr (eol + 1, length));
+    position = eol + 1 + length;
+  }
+
+  // A file shorter than the offset of its record is not the one the record
+  // was logged against. Nothing is replayed, and the log is kept.
+  for (auto& record : records)
+  {
+    auto offset = std::get <1> (record);
+    auto& file = std::get <2> (record);
+    if (std::get <0> (record) == "write" && offset &&
+        (! File (file).exists () || File (file).size () < offset))
+    {
+      throw format ("Cannot replay '{1}', as '{2}' is shorter than logged. Database corruption possible.", path, file);
+    }
+  }
+
+  for (auto& record : records)
+  {
+    impl::apply_wal_record (std::get <0> (record), std::get <1> (record), std::get <2> (record), std::get <3> (record));
+  }
+
+  std::remove (path.c_str ());
+  return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
 // reset - Removes all current atomic files from finalization
 void AtomicFile::reset ()
 {
-  impl::atomic_files.clear ();
-  impl::allow_atomics = true;
+  impl::changes ()._files.clear ();
+  impl::changes ()._allowed = true;
 }
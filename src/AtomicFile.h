@@ -27,6 +27,7 @@
 #define INCLUDED_ATOMICFILE
 
 #include <memory>
+#include <string>
 #include <vector>
 
 class Path;
@@ -34,6 +35,39 @@ class Path;
 class AtomicFile
 {
 public:
+  struct impl;
+
+  // The files changed and not yet finalized, and whether all of them could be
+  // written. The command line uses those of its thread. A Session keeps its
+  // own, and makes them current for each call with a Scope.
+  class Changes
+  {
+  public:
+    Changes ();
+    ~Changes ();
+    Changes (const Changes&) = delete;
+    Changes& operator= (const Changes&) = delete;
+
+  private:
+    friend class AtomicFile;
+    friend struct AtomicFile::impl;
+
+    std::vector <std::shared_ptr <impl>> _files   {};
+    bool                                 _allowed {true};
+  };
+
+  class Scope
+  {
+  public:
+    explicit Scope (Changes&);
+    Scope (const Scope&) = delete;
+    Scope& operator= (const Scope&) = delete;
+    ~Scope ();
+
+  private:
+    Changes* _previous;
+  };
+
   AtomicFile (const Path& path);
   AtomicFile (std::string path);
   AtomicFile (const AtomicFile&) = delete;
@@ -53,8 +87,11 @@ public:
   size_t size () const;
   void read (std::string& content);
   void read (std::vector <std::string>& lines);
+  void read (std::string& content, size_t offset);
   void append (const std::string& content);
   void write_raw (const std::string& content);
+  void replace_tail (size_t offset, const std::string& content);
+  void expect (const std::string& stamp);
 
   static void append (const std::string& path, const std::string& data);
   static void append (const Path& path, const std::string& data);
@@ -67,11 +104,12 @@ public:
   static void read (const Path& path, std::string& content);
   static void read (const Path& path, std::vector <std::string>& lines);
 
-  static void finalize_all ();
+  static bool pending ();
+  static void verify ();
+  static void finalize_all (const std::string& wal_path = "");
   static void reset ();
 
-public:
-  struct impl;
+  static bool replay_wal (const std::string& path);
 
 private:
   std::shared_ptr <impl> pimpl;
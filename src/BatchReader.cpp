@@ -0,0 +1,201 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <BatchReader.h>
+#include <FS.h>
+#include <format.h>
+#include <timew.h>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#endif
+
+// The most reads in flight at once.
+static const unsigned int queueDepth = 64;
+
+////////////////////////////////////////////////////////////////////////////////
+void BatchReader::add (const std::string& path)
+{
+  _paths.push_back (path);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+size_t BatchReader::size () const
+{
+  return _paths.size ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Calls consume with the index and contents of every file that was added. A
+// file that cannot be read has empty contents.
+void BatchReader::read (const std::function <void (size_t, const std::string&)>& consume)
+{
+  if (readBatched (consume))
+    return;
+
+  for (size_t i = 0; i < _paths.size (); ++i)
+  {
+    std::string content;
+    File::read (_paths[i], content);
+    consume (i, content);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Returns false, having consumed nothing, if io_uring is not available.
+#ifdef HAVE_LIBURING
+bool BatchReader::readBatched (const std::function <void (size_t, const std::string&)>& consume)
+{
+  struct io_uring ring;
+  if (io_uring_queue_init (std::min <unsigned int> (queueDepth, std::max <size_t> (_paths.size (), 1)), &ring, 0) < 0)
+    return false;
+
+  debug (format ("Reading {1} files with io_uring", _paths.size ()));
+
+  std::vector <std::string> contents (_paths.size ());
+  std::vector <int> descriptors (_paths.size (), -1);
+  std::vector <bool> consumed (_paths.size (), false);
+
+  // Reads are queued in the ring, then submitted, and in flight until they
+  // complete.
+  size_t next = 0;
+  size_t queued = 0;
+  size_t pending = 0;
+  while (next < _paths.size () || queued || pending)
+  {
+    // Queue reads, up to the depth of the ring.
+    while (next < _paths.size () && queued + pending < queueDepth)
+    {
+      auto i = next++;
+
+      struct stat info;
+      int fd = ::open (_paths[i].c_str (), O_RDONLY);
+      if (fd == -1 || ::fstat (fd, &info) == -1 || info.st_size == 0)
+      {
+        if (fd != -1)
+          ::close (fd);
+
+        consume (i, contents[i]);
+        consumed[i] = true;
+        continue;
+      }
+
+      // With the ring full, the file is queued again later.
+      auto sqe = io_uring_get_sqe (&ring);
+      if (! sqe)
+      {
+        ::close (fd);
+        --next;
+        break;
+      }
+
+      descriptors[i] = fd;
+      contents[i].resize (info.st_size);
+
+      io_uring_prep_read (sqe, fd, &contents[i][0], info.st_size, 0);
+      io_uring_sqe_set_data (sqe, reinterpret_cast <void*> (i));
+      ++queued;
+    }
+
+    // Reads not submitted stay queued for the next submit. If none can be
+    // submitted and none are in flight, no read will complete, and the rest
+    // are read the plain way.
+    if (! queued && ! pending && next < _paths.size ())
+      break;
+
+    if (queued)
+    {
+      auto submitted = io_uring_submit (&ring);
+      if (submitted > 0)
+      {
+        queued -= std::min <size_t> (submitted, queued);
+        pending += submitted;
+      }
+      else if (! pending)
+      {
+        break;
+      }
+    }
+
+    // Hand on each file as its read completes.
+    if (pending)
+    {
+      struct io_uring_cqe* cqe;
+      if (io_uring_wait_cqe (&ring, &cqe) < 0)
+        break;
+
+      auto i = reinterpret_cast <size_t> (io_uring_cqe_get_data (cqe));
+      auto result = cqe->res;
+      io_uring_cqe_seen (&ring, cqe);
+      --pending;
+
+      ::close (descriptors[i]);
+      descriptors[i] = -1;
+
+      // A failed or short read, as when the file changed since it was sized,
+      // is repeated the plain way.
+      if (result < 0 || static_cast <size_t> (result) != contents[i].size ())
+        File::read (_paths[i], contents[i]);
+
+      consume (i, contents[i]);
+      consumed[i] = true;
+      contents[i].clear ();
+      contents[i].shrink_to_fit ();
+    }
+  }
+
+  io_uring_queue_exit (&ring);
+
+  // If submitting or waiting failed, the remaining files are read the plain
+  // way, not into the buffers given to the ring.
+  for (size_t i = 0; i < _paths.size (); ++i)
+  {
+    if (descriptors[i] != -1)
+      ::close (descriptors[i]);
+
+    if (! consumed[i])
+    {
+      std::string content;
+      File::read (_paths[i], content);
+      consume (i, content);
+    }
+  }
+
+  return true;
+}
+#else
+bool BatchReader::readBatched (const std::function <void (size_t, const std::string&)>&)
+{
+  return false;
+}
+#endif
+
+////////////////////////////////////////////////////////////////////////////////
@@ -26,6 +26,7 @@
 
 #include <cmake.h>
 #include <CLI.h>
+#include <Clock.h>
 #include <Color.h>
 #include <Pig.h>
 #include <shared.h>
@@ -37,6 +38,7 @@
 #include <Duration.h>
 #include <timew.h>
 #include "DatetimeParser.h"
+#include <AnnotationIndex.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 A2::A2 (const std::string& raw, Lexer::Type lextype)
@@ -527,6 +529,19 @@ void CLI::identifyFilter ()
     {
       a.tag ("DOM");
     }
+
+    else if (raw.rfind ("tags:", 0) == 0)
+    {
+      a.tag ("FILTER");
+      a.tag ("EXPRESSION");
+    }
+
+    else if (raw.rfind ("annotation:~", 0) == 0)
+    {
+      a.tag ("FILTER");
+      a.tag ("ANNOTATION");
+    }
+
     else
     {
       a.tag ("FILTER");
@@ -628,6 +643,44 @@ std::vector <std::string> CLI::getDomReferences () const
   return references;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// All 'tags:<expression>' arguments, combined with 'and'.
+TagExpression CLI::getTagExpression () const
+{
+  TagExpression expression;
+
+  for (auto& arg : _args)
+  {
+    if (arg.hasTag ("EXPRESSION"))
+    {
+      expression.conjoin (TagExpression (arg.attribute ("raw").substr (5)));
+    }
+  }
+
+  return expression;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The words of all 'annotation:~<word>' arguments, which must all be found in
+// the annotation of an interval.
+std::vector <std::string> CLI::getAnnotationWords () const
+{
+  std::vector <std::string> words;
+
+  for (auto& arg : _args)
+  {
+    if (arg.hasTag ("ANNOTATION"))
+    {
+      for (auto& word : AnnotationIndex::tokenize (arg.attribute ("raw").substr (12)))
+      {
+        words.push_back (word);
+      }
+    }
+  }
+
+  return words;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // A filter is just another interval, containing start, end and tags.
 //
@@ -640,7 +693,7 @@ std::vector <std::string> CLI::getDomReferences () const
 Interval CLI::getFilter (const Range& default_range) const
 {
   // One instance, so we can directly compare.
-  Datetime now;
+  Datetime now = Clock::now ();
 
   Interval filter;
   std::string start;
@@ -709,6 +762,14 @@ Interval CLI::getFilter (const Range& default_range) const
       {
         // Not part of a filter.
       }
+      else if (arg.hasTag ("EXPRESSION"))
+      {
+        // See ::getTagExpression.
+      }
+      else if (arg.hasTag ("ANNOTATION"))
+      {
+        // See ::getAnnotationWords.
+      }
       else
       {
         filter.tag (raw);
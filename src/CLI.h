@@ -34,6 +34,7 @@
 #include <map>
 #include <Duration.h>
 #include "Interval.h"
+#include "TagExpression.h"
 
 // Represents a single argument.
 class A2
@@ -73,6 +74,8 @@ public:
   Duration getDuration() const;
   std::vector<std::string> getDomReferences () const;
   Interval getFilter (const Range& = {}) const;
+  TagExpression getTagExpression () const;
+  std::vector <std::string> getAnnotationWords () const;
   std::string dump (const std::string& title = "CLI Parser") const;
 
 private:
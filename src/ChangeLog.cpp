@@ -0,0 +1,227 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <ChangeLog.h>
+#include <AtomicFile.h>
+#include <FS.h>
+#include <algorithm>
+#include <cstdlib>
+
+// A new segment is started once the last one holds this many changes.
+static const unsigned int segmentSize = 4096;
+
+////////////////////////////////////////////////////////////////////////////////
+// Segments are named by their first sequence number, padded so that sorting
+// them by name also sorts them by number.
+static std::string segmentName (long long seq)
+{
+  auto name = std::to_string (seq);
+  if (name.length () < 12)
+  {
+    name.insert (0, 12 - name.length (), '0');
+  }
+
+  return name + ".data";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static long long segmentStart (const std::string& file)
+{
+  return std::strtoll (Path (file).name ().c_str (), nullptr, 10);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Every entry starts with its sequence number: {"seq":<n>,...
+static long long sequence (const std::string& entry)
+{
+  return entry.length () > 7 ? std::strtoll (entry.c_str () + 7, nullptr, 10) : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void ChangeLog::initialize (const std::string& location)
+{
+  _location = location;
+  _segment.clear ();
+  _next = 0;
+  _lines = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool ChangeLog::enabled () const
+{
+  return ! _location.empty ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Record a change to an interval, where an empty before or after is an interval
+// added or deleted. It is numbered and written when published.
+void ChangeLog::record (const std::string& before, const std::string& after)
+{
+  if (! enabled ())
+  {
+    return;
+  }
+
+  _pending.emplace_back (before, after);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Number the recorded changes after the last entry as it is now, and append
+// them to the log. Must be called with the generation of the database begun,
+// before the files are finalized, so that the entries are written with the
+// changes they describe.
+void ChangeLog::publish ()
+{
+  if (_pending.empty ())
+  {
+    return;
+  }
+
+  load ();
+
+  for (auto& change : _pending)
+  {
+    if (_lines >= segmentSize)
+    {
+      _segment = _location + "/" + segmentName (_next);
+      _lines = 0;
+    }
+
+    AtomicFile::append (_segment,
+                        "{\"seq\":" + std::to_string (_next) +
+                        ",\"before\":" + (change.first.empty () ? "null" : change.first) +
+                        ",\"after\":" + (change.second.empty () ? "null" : change.second) +
+                        "}\n");
+    ++_next;
+    ++_lines;
+  }
+
+  _pending.clear ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Forget the recorded changes, which were not written.
+void ChangeLog::discard ()
+{
+  _pending.clear ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The entries with a sequence number greater than cursor, oldest first. Only
+// the segments from the one holding the entry after cursor are read.
+std::vector <std::string> ChangeLog::since (long long cursor) const
+{
+  auto files = segments ();
+
+  auto first = files.begin ();
+  for (auto it = files.begin (); it != files.end (); ++it)
+  {
+    if (segmentStart (*it) <= cursor + 1)
+    {
+      first = it;
+    }
+  }
+
+  std::vector <std::string> entries;
+  for (auto it = first; it != files.end (); ++it)
+  {
+    std::vector <std::string> lines;
+    AtomicFile::read (Path (*it), lines);
+
+    for (auto& line : lines)
+    {
+      if (sequence (line) > cursor)
+      {
+        entries.push_back (line);
+      }
+    }
+  }
+
+  return entries;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector <std::string> ChangeLog::segments () const
+{
+  std::vector <std::string> files;
+
+  Directory directory (_location);
+  if (! directory.exists ())
+  {
+    return files;
+  }
+
+  for (auto& file : directory.list ())
+  {
+    auto name = Path (file).name ();
+    if (name.length () == 17 && name.find (".data") == 12)
+    {
+      files.push_back (file);
+    }
+  }
+
+  std::sort (files.begin (), files.end ());
+  return files;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The next sequence number follows the last entry of the last segment.
+void ChangeLog::load ()
+{
+  auto files = segments ();
+  if (files.empty ())
+  {
+    Directory directory (_location);
+    if (! directory.exists ())
+    {
+      directory.create (0700);
+    }
+
+    _segment = _location + "/" + segmentName (1);
+    _next = 1;
+    _lines = 0;
+    return;
+  }
+
+  _segment = files.back ();
+  _next = segmentStart (_segment);
+
+  std::vector <std::string> lines;
+  AtomicFile::read (Path (_segment), lines);
+
+  _lines = 0;
+  for (auto& line : lines)
+  {
+    if (! line.empty ())
+    {
+      _next = sequence (line) + 1;
+      ++_lines;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
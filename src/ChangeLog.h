@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_CHANGELOG
+#define INCLUDED_CHANGELOG
+
+#include <string>
+#include <utility>
+#include <vector>
+
+// An append-only log of the changes to intervals, each numbered by a sequence
+// number that only ever increases, so that a reader can ask for the changes
+// after the last one it has seen. Unlike the journal, it is never trimmed.
+// The log is kept in segments named by their first sequence number, so that
+// appending copies only the last segment, and reading from a cursor skips the
+// segments before it.
+//
+// Changes are kept in memory until they are published, which the database
+// does under the lock of its generation, so that no two processes number their
+// changes from the same last entry.
+class ChangeLog
+{
+public:
+  void initialize (const std::string&);
+  bool enabled () const;
+
+  void record (const std::string&, const std::string&);
+  void publish ();
+  void discard ();
+  std::vector <std::string> since (long long) const;
+
+private:
+  std::vector <std::string> segments () const;
+  void load ();
+
+  std::string  _location {};
+  std::string  _segment  {};
+  long long    _next     {0};
+  unsigned int _lines    {0};
+  std::vector <std::pair <std::string, std::string>> _pending {};
+};
+
+#endif
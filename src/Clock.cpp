@@ -0,0 +1,121 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <Clock.h>
+
+// The clock of the run or Session on this thread.
+static thread_local Clock* active {nullptr};
+
+////////////////////////////////////////////////////////////////////////////////
+Clock::Scope::Scope (Clock& clock)
+: _previous (active)
+{
+  active = &clock;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Clock::Scope::~Scope ()
+{
+  active = _previous;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Captured on first use.
+const Datetime& Clock::time ()
+{
+  if (! _captured)
+  {
+    _now = Datetime ();
+    _captured = true;
+  }
+
+  return _now;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Clock::fix (const Datetime& value)
+{
+  _now = value;
+  _captured = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The next use captures the time anew.
+void Clock::release ()
+{
+  _captured = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const Datetime& Clock::now ()
+{
+  return current ().time ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The start of the day of now.
+Datetime Clock::today ()
+{
+  return now ().startOfDay ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The start of the day after now.
+Datetime Clock::tomorrow ()
+{
+  auto day = today ();
+  ++day;
+  return day;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Clock::set (const Datetime& value)
+{
+  current ().fix (value);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Clock::reset ()
+{
+  current ().release ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Code run outside of any scope, as in the unit tests, shares one clock per
+// thread.
+Clock& Clock::current ()
+{
+  if (active == nullptr)
+  {
+    static thread_local Clock fallback;
+    return fallback;
+  }
+
+  return *active;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,72 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_CLOCK
+#define INCLUDED_CLOCK
+
+#include <Datetime.h>
+
+// The current time, captured once, so that every comparison against 'now'
+// within one run agrees, and so that it can be fixed for testing.
+//
+// Each run owns a Clock, as does each Session of the API, and makes it the
+// current clock of its thread with a Clock::Scope. The static functions use
+// the current clock, so that they need not be passed down to every function
+// that compares against 'now'.
+class Clock
+{
+public:
+  class Scope
+  {
+  public:
+    explicit Scope (Clock&);
+    Scope (const Scope&) = delete;
+    Scope& operator= (const Scope&) = delete;
+    ~Scope ();
+
+  private:
+    Clock* _previous;
+  };
+
+  const Datetime& time ();
+  void fix (const Datetime&);
+  void release ();
+
+  static const Datetime& now ();
+  static Datetime today ();
+  static Datetime tomorrow ();
+  static void set (const Datetime&);
+  static void reset ();
+
+private:
+  static Clock& current ();
+
+private:
+  bool     _captured {false};
+  Datetime _now      {0};
+};
+
+#endif
@@ -24,7 +24,9 @@
 //
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <cassert>
+#include <map>
 #include <Database.h>
 #include <format.h>
 #include <JSON.h>
@@ -33,23 +35,46 @@
 #include <iomanip>
 #include <shared.h>
 #include <timew.h>
+#include <Clock.h>
 #include <AtomicFile.h>
+#include <BatchReader.h>
+#include <Generation.h>
+#include <unistd.h>
+
+// The number of files read ahead of the one being parsed.
+static const int prefetchDepth = 2;
+
+////////////////////////////////////////////////////////////////////////////////
+// Start reading the files following the current one, while it is parsed.
+template <typename T>
+static void prefetchAhead (T it, T end)
+{
+  for (int i = 0; i < prefetchDepth && it != end; ++i)
+  {
+    if (++it != end)
+      it->prefetch ();
+  }
+}
 
 ////////////////////////////////////////////////////////////////////////////////
-Database::iterator::iterator (files_iterator fbegin, files_iterator fend) :
+Database::iterator::iterator (Database* db, files_iterator fbegin, files_iterator fend) :
+          database(db),
           files_it(fbegin),
           files_end(fend)
 {
     if (files_end != files_it)
     {
+      prefetchAhead (files_it, files_end);
       auto &lines = files_it->allLines ();
       lines_it = lines.rbegin ();
       lines_end = lines.rend ();
       while ((lines_it == lines_end) && (files_it != files_end))
       {
+        database->passed (*files_it);
         ++files_it;
         if (files_it != files_end)
         {
+          prefetchAhead (files_it, files_end);
           auto& lines = files_it->allLines ();
           lines_it = lines.rbegin ();
           lines_end = lines.rend ();
@@ -72,9 +97,11 @@ Database::iterator& Database::iterator::operator++()
       // until we are pointing at a valid line.
       while ((lines_it == lines_end) && (files_it != files_end))
       {
+        database->passed (*files_it);
         ++files_it;
         if (files_it != files_end)
         {
+          prefetchAhead (files_it, files_end);
           auto& lines = files_it->allLines ();
           lines_it = lines.rbegin ();
           lines_end = lines.rend ();
@@ -124,6 +151,7 @@ Database::reverse_iterator::reverse_iterator (files_iterator fbegin,
 {
     if (files_end != files_it)
     {
+      prefetchAhead (files_it, files_end);
       lines_it = files_it->allLines ().begin ();
       lines_end = files_it->allLines ().end ();
       while ((lines_it == lines_end) && (files_it != files_end))
@@ -131,6 +159,7 @@ Database::reverse_iterator::reverse_iterator (files_iterator fbegin,
         ++files_it;
         if (files_it != files_end)
         {
+          prefetchAhead (files_it, files_end);
           auto& lines = files_it->allLines ();
           lines_it = lines.begin ();
           lines_end = lines.end ();
@@ -156,6 +185,7 @@ Database::reverse_iterator& Database::reverse_iterator::operator++()
         ++files_it;
         if (files_it != files_end)
         {
+          prefetchAhead (files_it, files_end);
           lines_it = files_it->allLines ().begin ();
           lines_end = files_it->allLines ().end ();
         }
@@ -205,7 +235,7 @@ Database::iterator Database::begin ()
     initializeDatafiles ();
   }
 
-  return iterator (_files.rbegin (), _files.rend ());
+  return iterator (this, _files.rbegin (), _files.rend ());
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -216,7 +246,7 @@ Database::iterator Database::end ()
     initializeDatafiles ();
   }
 
-  return iterator (_files.rend (), _files.rend ());
+  return iterator (this, _files.rend (), _files.rend ());
 }
 
 
@@ -243,293 +273,1422 @@ Database::reverse_iterator Database::rend ()
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void Database::initialize (const std::string& location, Journal& journal)
+// Unless verbose, nothing is written to stdout or stderr, for use as a library.
+void Database::initialize (
+  const std::string& location,
+  Journal& journal,
+  bool verbose)
 {
   _location = location;
   _journal = &journal;
-  initializeTagDatabase ();
-}
 
-////////////////////////////////////////////////////////////////////////////////
-void Database::commit ()
-{
-  for (auto& file : _files)
+  // Complete a commit that was interrupted while replacing the files. A commit
+  // in progress has a log as well, so the log is only replayed under the lock
+  // of the generation, if it is still there once the lock is held.
+  auto wal = _location + "/commit.wal";
+  if (File (wal).exists ())
   {
-    file.commit ();
+    Generation generation (_location + "/generation");
+    generation.begin ();
+    AtomicFile::replay_wal (wal);
+    generation.end ();
   }
 
-  if (_tagInfoDatabase.is_modified ())
-  {
-    AtomicFile::write (_location + "/tags.data", _tagInfoDatabase.toJson ());
-  }
+  initializeTagDatabase (verbose);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-std::vector <std::string> Database::files () const
+void Database::enableAnnotationIndex ()
 {
-  std::vector <std::string> all;
-  for (auto& file : _files)
-  {
-    all.push_back (file.name ());
-  }
-
-  return all;
+  _annotationIndexEnabled = true;
+  _annotationIndex.initialize (_location + "/annotations.data");
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-std::set <std::string> Database::tags () const
+bool Database::hasAnnotationIndex () const
 {
-  return _tagInfoDatabase.tags ();
+  return _annotationIndexEnabled;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// Return most recent line from database 
-std::string Database::getLatestEntry ()
+void Database::enableChangeLog ()
 {
-  for (auto& line : *this)
-  {
-    if (! line.empty ())
-    {
-      return line;
-    }
-  }
+  _changeLog.initialize (_location + "/changes");
+}
 
-  return "";
+////////////////////////////////////////////////////////////////////////////////
+// Run the 'on-commit' scripts in <location>/hooks after changes are published.
+void Database::enableHooks (const std::string& location, unsigned int batch)
+{
+  _hooks.initialize (location, batch);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void Database::addInterval (const Interval& interval, bool verbose)
+// Catch up with the changes other processes published since the database was
+// read: data files are read again if they changed, new ones are found, and the
+// tags and the annotation index are loaded again. Only call this when there
+// are no changes waiting to be committed.
+void Database::refresh ()
 {
-  assert ( (interval.end == 0) || (interval.start <= interval.end));
+  for (auto& file : _files)
+  {
+    file.refresh ();
+  }
 
-  auto tags = interval.tags ();
-  for (auto& tag : tags)
+  if (! _files.empty ())
   {
-    if (_tagInfoDatabase.incrementTag (tag) == -1 && verbose)
-    {
-      std::cout << "Note: '" << quoteIfNeeded (tag) << "' is a new tag." << std::endl;
-    }
+    initializeDatafiles ();
   }
 
-  // Get the index into _files for the appropriate Datafile, which may be
-  // created on demand.
-  auto df = getDatafile (interval.start.year (), interval.start.month ());
-  _files[df].addInterval (interval);
-  _journal->recordIntervalAction ("", interval.json ());
+  initializeTagDatabase (false);
+
+  if (_annotationIndexEnabled)
+  {
+    _annotationIndex.initialize (_location + "/annotations.data");
+  }
 }
 
-void Database::deleteInterval (const Interval& interval)
+////////////////////////////////////////////////////////////////////////////////
+// The changes recorded after the change numbered cursor, as JSON objects.
+std::vector <std::string> Database::changesSince (long long cursor) const
 {
-  auto tags = interval.tags ();
-
-  for (auto& tag : tags)
+  if (! _changeLog.enabled ())
   {
-    _tagInfoDatabase.decrementTag (tag);
+    throw std::string ("The change log is not enabled. See 'changelog' in 'timew help config'.");
   }
 
-  // Get the index into _files for the appropriate Datafile, which may be
-  // created on demand.
-  auto df = getDatafile (interval.start.year (), interval.start.month ());
-
-  _files[df].deleteInterval (interval);
-  _journal->recordIntervalAction (interval.json (), "");
+  return _changeLog.since (cursor);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// The algorithm to modify an interval is first to find and remove it from the
-// Datafile, then add it back to the right Datafile. This is because
-// modification may involve changing the start date, which could mean the
-// Interval belongs in a different file.
-void Database::modifyInterval (const Interval& from, const Interval& to, bool verbose)
+void Database::commit ()
 {
-  if (!from.empty ())
+  // Only the files written here are verified against their checksums, and
+  // recorded, so that commands that only read never write to the database.
+  std::vector <std::pair <Datafile*, std::string>> written;
+  for (auto& file : _files)
   {
-    deleteInterval (from);
+    if (file.dirty ())
+    {
+      written.emplace_back (&file, file.checksum ());
+    }
+
+    file.commit ();
   }
 
-  if (!to.empty ())
+  bool edited = false;
+  if (! written.empty () && AtomicFile::pending ())
   {
-    addInterval (to, verbose);
+    edited = recordChecksums (written);
   }
-}
 
-////////////////////////////////////////////////////////////////////////////////
-std::string Database::dump () const
-{
-  std::stringstream out;
-  out << "Database\n";
-  for (auto& df : _files)
+  if (edited)
   {
-    out << df.dump ();
+    recountTags ();
   }
 
-  return out.str ();
-}
-
-////////////////////////////////////////////////////////////////////////////////
-unsigned int Database::getDatafile (int year, int month)
-{
-  std::stringstream file;
-  file << _location
-       << '/'
-       << std::setw (4) << std::setfill ('0') << year
-       << '-'
-       << std::setw (2) << std::setfill ('0') << month
-       << ".data";
-  auto name = file.str ();
-  auto basename = Path (name).name ();
+  if (edited || _tagInfoDatabase.is_modified ())
+  {
+    AtomicFile::write (_location + "/tags.data", _tagInfoDatabase.toJson ());
+  }
 
-  // If the datafile is already initialized, return.
-  for (unsigned int i = 0; i < _files.size (); ++i)
+  // The months whose postings were shifted only take the checksum they were
+  // written with. Those changed otherwise are indexed again, now that their
+  // lines are sorted as they are stored.
+  if (_annotationIndexEnabled)
   {
-    if (_files[i].name () == basename)
+    for (auto& file : _files)
     {
-      return i;
+      auto name = file.name ();
+      if (! _annotationsChanged.count (name) && ! _annotationsUpdated.count (name))
+      {
+        continue;
+      }
+
+      if (file.allLines ().empty ())
+      {
+        _annotationIndex.remove (name);
+      }
+      else if (_annotationsChanged.count (name))
+      {
+        _annotationIndex.index (name, file.allLines (), file.checksum ());
+      }
+      else
+      {
+        _annotationIndex.written (name, file.checksum ());
+      }
     }
-  }
 
-  // Create the Datafile.
-  Datafile df;
-  df.initialize (name);
+    _annotationIndex.commit ();
+  }
 
-  // Insert Datafile into _files. The position is not important.
-  _files.push_back (df);
-  return _files.size () - 1;
+  _annotationsChanged.clear ();
+  _annotationsUpdated.clear ();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-// The input Daterange has a start and end, for example:
-//
-//   2016-02-20 to 2016-04-15
-//
-// Given the monthly storage scheme, split the Daterange into a vector of
-// segmented Dateranges:
-//
-//   2016-02-01 to 2016-03-01
-//   2016-03-01 to 2016-04-01
-//   2016-04-01 to 2016-05-01
-//
-std::vector <Range> Database::segmentRange (const Range& range)
+// Verify the data files against their checksums. Files that match are only
+// hashed, the others are parsed, and every line that is not an interval is
+// reported. Files that differ but parse were edited outside of Timewarrior,
+// and are accepted as they are, once no problems remain. Returns the problems
+// found.
+std::vector <std::string> Database::check (unsigned int& files, unsigned int& edited)
 {
-  std::vector <Range> segments;
-
-  auto start_y = range.start.year ();
-  auto start_m = range.start.month ();
-
-  auto end = range.end;
-  if (end.toEpoch () == 0)
+  if (_files.empty ())
   {
-    end = Datetime ();
+    initializeDatafiles ();
   }
 
-  auto end_y = end.year ();
-  auto end_m = end.month ();
+  loadChecksums ();
+  files = 0;
+  edited = 0;
 
-  while (start_y < end_y ||
-         (start_y == end_y && start_m <= end_m))
+  std::vector <std::string> problems;
+  struct Accepted
   {
-    // Capture date before incrementing month.
-    Datetime segmentStart (start_y, start_m, 1);
+    Datafile*   file;
+    std::string contents;
+    std::string stamp;
+  };
 
-    // Next month.
-    start_m += 1;
-    if (start_m > 12)
+  std::vector <Accepted> accepted;
+  std::map <std::string, std::string> verified;
+  for (auto& file : _files)
+  {
+    auto stamp = fileStamp (file.path ());
+    std::string contents;
+    if (! File::read (file.path (), contents))
     {
-      start_y += 1;
-      start_m = 1;
+      continue;
     }
 
-    // Capture date after incrementing month.
-    Datetime segmentEnd (start_y, start_m, 1);
-    auto segment = Range (segmentStart, segmentEnd);
-    if (range.intersects (segment))
+    ++files;
+    auto recorded = _checksums.find (file.name ());
+    if (recorded != _checksums.end () && recorded->second == contentHash (contents))
     {
-      segments.push_back (segment);
+      verified[file.name ()] = stamp;
+      continue;
     }
-  }
-
-  return segments;
-}
-
-bool Database::empty ()
-{
-  return Database::begin () == Database::end ();
-}
-
-////////////////////////////////////////////////////////////////////////////////
-void Database::initializeTagDatabase ()
-{
-  _tagInfoDatabase = TagInfoDatabase ();
-  Path tags_path (_location + "/tags.data");
-  std::string content;
-  const bool exists = tags_path.exists ();
 
-  if (exists && File::read (tags_path, content))
-  {
-    try
+    bool valid = true;
+    unsigned int number = 0;
+    for (auto& line : split (contents, '\n'))
     {
-      std::unique_ptr <json::object> json (dynamic_cast <json::object *>(json::parse (content)));
-
-      if (content.empty () || (json == nullptr))
+      ++number;
+      if (line.empty ())
       {
-          throw std::string ("Contents invalid.");
+        continue;
       }
 
-      for (auto &pair : json->_data)
+      try
       {
-        auto key = json::decode (pair.first);
-        auto *value = (json::object *) pair.second;
-        auto iter = value->_data.find ("count");
-
-        if (iter == value->_data.end ())
-        {
-          throw format ("Failed to find \"count\" member for tag \"{1}\" in tags database.", key);
-        }
+        IntervalFactory::fromSerialization (line);
+      }
+      catch (const std::string& error)
+      {
+        problems.push_back (format ("{1} line {2}: {3}", file.name (), number, error));
+        valid = false;
+      }
+    }
 
-        auto number = dynamic_cast<json::number *> (iter->second);
-        _tagInfoDatabase.add (key, TagInfo{(unsigned int) number->_dvalue});
+    if (valid)
+    {
+      if (recorded != _checksums.end ())
+      {
+        ++edited;
       }
 
-      // Since we just loaded the database from the file, there we can clear the
-      // modified state so that we will not write it back out unless there is a
-      // new change.
-      _tagInfoDatabase.clear_modified ();
+      accepted.push_back (Accepted {&file, contents, stamp});
+    }
+  }
 
-      return;
+  if (problems.empty () && ! accepted.empty ())
+  {
+    for (auto& file : accepted)
+    {
+      file.file->load (file.contents, file.stamp);
+      _checksums[file.file->name ()] = file.file->checksum ();
+      verified[file.file->name ()] = file.stamp;
     }
-    catch (const std::string& error)
+
+    if (edited)
     {
-      std::cerr << "Error parsing tags database: " << error << '\n';
+      recountTags ();
     }
+
+    writeChecksums ();
   }
 
-  // We always want the tag database file to exists.
-  _tagInfoDatabase = TagInfoDatabase();
-  AtomicFile::write (_location + "/tags.data", _tagInfoDatabase.toJson ());
+  // The stamps of the files verified are recorded as they were read, so that
+  // readers need not read them again.
+  if (problems.empty ())
+  {
+    _publishing.insert (verified.begin (), verified.end ());
+  }
 
-  auto it = Database::begin ();
-  auto end = Database::end ();
-  
-  if (it == end)
+  return problems;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Replace the files written by commit, within a new generation. The files of
+// another database, at location, may be replaced in the same commit, within a
+// new generation of that database as well. Generations are begun in the order
+// of their paths, so that two commits of the same databases cannot each hold
+// one while waiting for the other.
+void Database::publish (const std::string& location)
+{
+  if (! AtomicFile::pending () && _publishing.empty ())
   {
+    AtomicFile::finalize_all ();
     return;
   }
 
-  if (!exists)
+  std::set <std::string> paths {_location + "/generation"};
+  if (! location.empty ())
   {
-    std::cout << "Tags database does not exist. ";
+    paths.insert (location + "/generation");
   }
-  
-  std::cout << "Recreating from interval data..." << std::endl;
 
-  for (; it != end; ++it)
+  std::list <Generation> generations;
+  for (auto& path : paths)
   {
-    Interval interval = IntervalFactory::fromSerialization (*it);
-    for (auto& tag : interval.tags ())
+    generations.emplace_back (path);
+    generations.back ().begin ();
+  }
+
+  // Files changed by another process since they were read are only found
+  // under the lock. Nothing was replaced then, so the generations end. The
+  // change log is numbered under the lock as well, and replaced along with the
+  // data files.
+  try
+  {
+    AtomicFile::verify ();
+    _changeLog.publish ();
+  }
+  catch (...)
+  {
+    _changeLog.discard ();
+    for (auto& generation : generations)
     {
-      _tagInfoDatabase.incrementTag (tag);
+      generation.end ();
+    }
+
+    throw;
+  }
+
+  AtomicFile::finalize_all (_location + "/commit.wal");
+
+  for (auto& file : _files)
+  {
+    if (file.published ())
+    {
+      _publishing[file.name ()] = fileStamp (file.path ());
     }
   }
+
+  recordStamps ();
+
+  for (auto& generation : generations)
+  {
+    generation.end ();
+  }
+
+  // Hooks only see changes that were published.
+  _hooksQueued = _hooks.enqueue () || _hooksQueued;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Start delivering the published changes to the hooks, without waiting for
+// them.
+void Database::runHooks () const
+{
+  if (_hooksQueued)
+  {
+    _hooks.start ();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Open all data files at one generation, so that a long report reads one
+// consistent version of the database, while writers replace files as usual.
+// Writers never wait; if they keep committing, the files are read as they are.
+void Database::snapshot ()
+{
+  for (auto& mounted : _mounts)
+  {
+    mounted->snapshot ();
+  }
+
+  Generation generation (_location + "/generation");
+
+  for (int attempt = 0; attempt < 10; ++attempt)
+  {
+    auto before = generation.read ();
+    if (before % 2 == 0)
+    {
+      // Files created by the generation are only found now.
+      initializeDatafiles ();
+
+      bool pinned = true;
+      for (auto& file : _files)
+        pinned = pinned && file.pin ();
+
+      if (pinned && generation.read () == before)
+      {
+        debug (format ("Reading generation {1}", before));
+        return;
+      }
+
+      for (auto& file : _files)
+        file.unpin ();
+
+      // Descriptors ran out, which will not change.
+      if (! pinned)
+        return;
+    }
+
+    ::usleep (1000);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector <std::string> Database::files ()
+{
+  if (_files.empty ())
+  {
+    initializeDatafiles ();
+  }
+
+  std::vector <std::string> all;
+  for (auto& file : _files)
+  {
+    all.push_back (file.name ());
+  }
+
+  return all;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::set <std::string> Database::tags () const
+{
+  return _tagInfoDatabase.tags ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const TagInfoDatabase& Database::tagInfoDatabase () const
+{
+  return _tagInfoDatabase;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The tags of this database and of the databases mounted on it, related by the
+// tag separator, for reports over all of them.
+TagInfoDatabase Database::tagHierarchy () const
+{
+  auto hierarchy = _tagInfoDatabase;
+  for (auto& mounted : _mounts)
+  {
+    for (auto& tag : mounted->tags ())
+    {
+      hierarchy.add (tag, TagInfo {mounted->_tagInfoDatabase.count (tag)});
+    }
+  }
+
+  return hierarchy;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The separator also applies to the tags read or counted again later, and to
+// the mounted databases.
+void Database::setTagSeparator (const std::string& separator)
+{
+  _tagSeparator = separator;
+  _tagInfoDatabase.setSeparator (separator);
+
+  for (auto& mounted : _mounts)
+  {
+    mounted->setTagSeparator (separator);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The memory, in bytes, that the lines of files already scanned may hold. Zero
+// means unbounded.
+void Database::setMemoryBudget (size_t bytes)
+{
+  _memoryBudget = bytes;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Mount the database at location for queries, as the source of its intervals.
+// A mounted database is only read: an interrupted commit is not completed,
+// and a missing tag database is recreated in memory only.
+void Database::mount (const std::string& location)
+{
+  Directory data (Directory (location)._data + "/data");
+  if (! data.is_directory ())
+  {
+    throw format ("There is no database at '{1}'", location);
+  }
+
+  auto mounted = std::make_shared <Database> ();
+  mounted->_location = data._data;
+  mounted->_journal = _journal;
+  mounted->_memoryBudget = _memoryBudget;
+  mounted->_source = location;
+  mounted->_tagSeparator = _tagSeparator;
+  mounted->initializeTagDatabase (false);
+
+  _mounts.push_back (mounted);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector <Database*> Database::mounts () const
+{
+  std::vector <Database*> databases;
+  for (auto& mounted : _mounts)
+  {
+    databases.push_back (mounted.get ());
+  }
+
+  return databases;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The location a mounted database was mounted from, empty for this database.
+const std::string& Database::source () const
+{
+  return _source;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Return most recent line from database 
+std::string Database::getLatestEntry ()
+{
+  for (auto& line : *this)
+  {
+    if (! line.empty ())
+    {
+      return line;
+    }
+  }
+
+  return "";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Read all the data files for the range that are not yet loaded in one batch,
+// instead of one by one as the iterators reach them.
+void Database::preload (const Range& range)
+{
+  BatchReader reader;
+  std::vector <Datafile*> files;
+  std::vector <std::string> stamps;
+  size_t bytes = 0;
+  for (auto file = _files.rbegin (); file != _files.rend (); ++file)
+  {
+    if (! file->loaded () &&
+        ! file->pinned () &&
+        (! range.is_started () || file->range ().end > range.start) &&
+        (! range.is_ended ()   || file->range ().start < range.end))
+    {
+      // The newest files are read first, and no more than the budget.
+      bytes += File (file->path ()).size ();
+      if (_memoryBudget && bytes > _memoryBudget)
+        break;
+
+      reader.add (file->path ());
+      files.push_back (&*file);
+      stamps.push_back (fileStamp (file->path ()));
+    }
+  }
+
+  if (files.size () < 2)
+    return;
+
+  reader.read ([&] (size_t i, const std::string& contents)
+  {
+    files[i]->load (contents, stamps[i]);
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Database::addInterval (const Interval& interval, bool verbose)
+{
+  assert ( (interval.end == 0) || (interval.start <= interval.end));
+
+  auto tags = interval.tags ();
+  for (auto& tag : tags)
+  {
+    if (_tagInfoDatabase.incrementTag (tag) == -1 && verbose)
+    {
+      std::cout << "Note: '" << quoteIfNeeded (tag) << "' is a new tag." << std::endl;
+    }
+  }
+
+  // Get the index into _files for the appropriate Datafile, which may be
+  // created on demand.
+  auto df = getDatafile (interval.start.year (), interval.start.month ());
+  _files[df].addInterval (interval);
+  annotationAdded (_files[df], _files[df].sortedPosition (interval.serialize ()), interval);
+  recordChange ("", interval.json ());
+}
+
+void Database::deleteInterval (const Interval& interval)
+{
+  auto tags = interval.tags ();
+
+  for (auto& tag : tags)
+  {
+    _tagInfoDatabase.decrementTag (tag);
+  }
+
+  // Get the index into _files for the appropriate Datafile, which may be
+  // created on demand.
+  auto df = getDatafile (interval.start.year (), interval.start.month ());
+  auto position = _files[df].sortedPosition (interval.serialize ());
+
+  _files[df].deleteInterval (interval);
+  annotationDeleted (_files[df], position);
+  recordChange (interval.json (), "");
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Delete intervals as deleteInterval does, passing over each data file once.
+void Database::deleteIntervals (const std::vector <Interval>& intervals)
+{
+  std::map <unsigned int, std::vector <Interval>> byFile;
+  for (auto& interval : intervals)
+  {
+    for (auto& tag : interval.tags ())
+    {
+      _tagInfoDatabase.decrementTag (tag);
+    }
+
+    byFile[getDatafile (interval.start.year (), interval.start.month ())].push_back (interval);
+  }
+
+  for (auto& file : byFile)
+  {
+    auto& datafile = _files[file.first];
+
+    // Positions are taken before any line is deleted, and the postings are
+    // shifted from the last one, so that each still holds.
+    std::vector <size_t> positions;
+    for (auto& interval : file.second)
+    {
+      positions.push_back (datafile.sortedPosition (interval.serialize ()));
+    }
+
+    std::sort (positions.rbegin (), positions.rend ());
+
+    datafile.deleteIntervals (file.second);
+    for (auto& position : positions)
+    {
+      annotationDeleted (datafile, position);
+    }
+  }
+
+  for (auto& interval : intervals)
+  {
+    recordChange (interval.json (), "");
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The algorithm to modify an interval is first to find and remove it from the
+// Datafile, then add it back to the right Datafile. This is because
+// modification may involve changing the start date, which could mean the
+// Interval belongs in a different file.
+void Database::modifyInterval (const Interval& from, const Interval& to, bool verbose)
+{
+  if (!from.empty ())
+  {
+    deleteInterval (from);
+  }
+
+  if (!to.empty ())
+  {
+    addInterval (to, verbose);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Rename a tag to one that no interval has yet, which is undone by renaming it
+// back. If some intervals have it, renaming back would change them as well, so
+// the tags are merged instead.
+unsigned int Database::renameTag (const std::string& from, const std::string& to)
+{
+  if (_tagInfoDatabase.count (to) > 0)
+  {
+    return mergeTags ({from}, to);
+  }
+
+  auto count = retag ({from}, to, false);
+  if (count)
+  {
+    _journal->recordTagAction (from, to);
+  }
+
+  return count;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Replace tags by one, which some intervals may have already. Every interval
+// changed is journaled, as this cannot be undone by renaming.
+unsigned int Database::mergeTags (const std::set <std::string>& from, const std::string& to)
+{
+  return retag (from, to, true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Replace the tags from by to in all intervals, reading and writing every data
+// file once.
+unsigned int Database::retag (const std::set <std::string>& from, const std::string& to, bool journal)
+{
+  // Most lines cannot contain any of the tags, and need not be parsed, unless
+  // the tags are escaped in the data files.
+  bool literal = std::none_of (from.begin (), from.end (), [] (const std::string& tag)
+  {
+    return tag.find_first_of ("\\\"") != std::string::npos;
+  });
+
+  if (_files.empty ())
+  {
+    initializeDatafiles ();
+  }
+
+  preload (Range ());
+
+  unsigned int changed = 0;
+  unsigned int added = 0;
+  std::map <std::string, unsigned int> removed;
+
+  for (auto& file : _files)
+  {
+    auto lines = file.allLines ();
+    for (size_t i = 0; i < lines.size (); ++i)
+    {
+      if (literal &&
+          std::none_of (from.begin (), from.end (), [&] (const std::string& tag)
+          {
+            return lines[i].find (tag) != std::string::npos;
+          }))
+      {
+        continue;
+      }
+
+      Interval interval = IntervalFactory::fromSerialization (lines[i]);
+      bool found = false;
+      for (auto& tag : from)
+      {
+        if (interval.hasTag (tag))
+        {
+          interval.untag (tag);
+          ++removed[tag];
+          found = true;
+        }
+      }
+
+      if (! found)
+      {
+        continue;
+      }
+
+      if (! interval.hasTag (to))
+      {
+        interval.tag (to);
+        ++added;
+      }
+
+      // A rename is journaled once for all intervals, but every change is
+      // logged.
+      auto before = IntervalFactory::fromSerialization (lines[i]).json ();
+      if (journal)
+      {
+        recordChange (before, "");
+        recordChange ("", interval.json ());
+      }
+      else
+      {
+        logChange (before, "");
+        logChange ("", interval.json ());
+      }
+
+      file.replaceInterval (i, interval);
+      _annotationsChanged.insert (file.name ());
+      ++changed;
+    }
+
+    passed (file);
+  }
+
+  // The counts are updated once, rather than for each interval.
+  for (auto& tag : removed)
+  {
+    auto count = _tagInfoDatabase.count (tag.first);
+    _tagInfoDatabase.setCount (tag.first, count > tag.second ? count - tag.second : 0);
+  }
+
+  if (added)
+  {
+    _tagInfoDatabase.setCount (to, _tagInfoDatabase.count (to) + added);
+  }
+
+  return changed;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Remove all tracked time before cutoff, returning the number of intervals
+// removed. Months entirely before the cutoff are emptied, and so removed on
+// commit, and only intervals reaching past the cutoff are kept, starting at
+// the cutoff. The change is not journaled, but it is logged.
+unsigned int Database::purge (const Datetime& cutoff)
+{
+  if (_files.empty ())
+  {
+    initializeDatafiles ();
+  }
+
+  Range before;
+  before.end = cutoff;
+  preload (before);
+
+  unsigned int purged = 0;
+  std::map <std::string, unsigned int> removed;
+  std::vector <Interval> trimmed;
+
+  for (auto& file : _files)
+  {
+    if (! (file.range ().start < cutoff))
+    {
+      continue;
+    }
+
+    std::vector <Interval> kept;
+    bool changed = false;
+    for (auto& line : file.allLines ())
+    {
+      Interval interval = IntervalFactory::fromSerialization (line);
+      if (! (interval.start < cutoff))
+      {
+        kept.push_back (interval);
+        continue;
+      }
+
+      for (auto& tag : interval.tags ())
+      {
+        ++removed[tag];
+      }
+
+      logChange (interval.json (), "");
+
+      if (interval.is_open () || interval.end > cutoff)
+      {
+        interval.start = cutoff;
+        trimmed.push_back (interval);
+      }
+      else
+      {
+        ++purged;
+      }
+
+      changed = true;
+    }
+
+    if (changed)
+    {
+      file.clear ();
+      for (auto& interval : kept)
+      {
+        file.addInterval (interval);
+      }
+
+      _annotationsChanged.insert (file.name ());
+    }
+  }
+
+  // The counts are updated once, rather than for each interval.
+  for (auto& tag : removed)
+  {
+    auto count = _tagInfoDatabase.count (tag.first);
+    _tagInfoDatabase.setCount (tag.first, count > tag.second ? count - tag.second : 0);
+  }
+
+  for (auto& interval : trimmed)
+  {
+    addInterval (interval, false);
+  }
+
+  _journal->forgetBefore (cutoff);
+
+  return purged;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Interval changes are journaled for undo, and logged for readers of the
+// change log and for the hooks.
+void Database::recordChange (const std::string& before, const std::string& after)
+{
+  _journal->recordIntervalAction (before, after);
+  logChange (before, after);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Database::logChange (const std::string& before, const std::string& after)
+{
+  _changeLog.record (before, after);
+  _hooks.record (before, after);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Find the lines whose annotation contains all the words, using the annotation
+// index so that only the data files with a match are read. Each line is paired
+// with its position counted from the latest interval, starting at 1, which is
+// the position at which iteration would have yielded it.
+//
+// Only the months that may hold intervals overlapping range are searched. The
+// later ones are counted, and the walk ends after the first earlier month with
+// lines, whose last interval may still reach into range.
+//
+// A month is fresh if the index has the checksum recorded for its data file,
+// and the file was not edited since. Other months, and those changed in this
+// session, are indexed again first.
+std::vector <std::pair <int, std::string>> Database::findAnnotated (
+  const std::vector <std::string>& words,
+  const Range& range)
+{
+  assert (_annotationIndexEnabled);
+
+  if (_files.empty ())
+  {
+    initializeDatafiles ();
+  }
+
+  auto edited = editedFiles ();
+  std::vector <std::pair <int, std::string>> found;
+  int position = 0;
+
+  for (auto file = _files.rbegin (); file != _files.rend (); ++file)
+  {
+    auto name = file->name ();
+    auto recorded = _checksums.find (name);
+    bool fresh = ! _annotationsChanged.count (name) &&
+                 ! _annotationsUpdated.count (name) &&
+                 ! edited.count (name) &&
+                 recorded != _checksums.end () &&
+                 _annotationIndex.fresh (name, recorded->second);
+
+    bool later = range.is_ended () && file->range ().start >= range.end;
+    if (later && ! fresh)
+    {
+      position += file->allLines ().size ();
+      continue;
+    }
+
+    if (! fresh)
+    {
+      // Postings shifted in this session are those of the file as it will be
+      // sorted, not of its lines now, so it is indexed again on commit.
+      if (_annotationsUpdated.count (name))
+      {
+        _annotationsChanged.insert (name);
+      }
+
+      _annotationIndex.index (name, file->allLines (), file->checksum ());
+    }
+
+    auto lines = _annotationIndex.lines (name);
+    auto matches = later ? std::vector <unsigned int> () : _annotationIndex.find (name, words);
+    if (! matches.empty ())
+    {
+      auto& all = file->allLines ();
+      for (auto line = matches.rbegin (); line != matches.rend (); ++line)
+      {
+        if (*line < all.size ())
+        {
+          found.emplace_back (position + lines - *line, all[*line]);
+        }
+      }
+    }
+
+    position += lines;
+
+    if (range.is_started () && file->range ().end <= range.start && lines > 0)
+    {
+      break;
+    }
+  }
+
+  return found;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Shift the postings of a fresh month for a line added at position once the
+// file is sorted. Other months are indexed again on commit.
+void Database::annotationAdded (Datafile& file, size_t position, const Interval& interval)
+{
+  if (! _annotationIndexEnabled)
+  {
+    return;
+  }
+
+  auto name = file.name ();
+  if (! _annotationsChanged.count (name) &&
+      (_annotationsUpdated.count (name) || _annotationIndex.fresh (name, file.checksum ())))
+  {
+    Interval copy {interval};
+    _annotationIndex.insert (name, position, copy.getAnnotation ());
+    _annotationsUpdated.insert (name);
+  }
+  else
+  {
+    _annotationsChanged.insert (name);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// As annotationAdded, for a line deleted at position.
+void Database::annotationDeleted (Datafile& file, size_t position)
+{
+  if (! _annotationIndexEnabled)
+  {
+    return;
+  }
+
+  auto name = file.name ();
+  if (! _annotationsChanged.count (name) &&
+      (_annotationsUpdated.count (name) || _annotationIndex.fresh (name, file.checksum ())))
+  {
+    _annotationIndex.erase (name, position);
+    _annotationsUpdated.insert (name);
+  }
+  else
+  {
+    _annotationsChanged.insert (name);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string Database::dump () const
+{
+  std::stringstream out;
+  out << "Database\n";
+  for (auto& df : _files)
+  {
+    out << df.dump ();
+  }
+
+  return out.str ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned int Database::getDatafile (int year, int month)
+{
+  std::stringstream file;
+  file << _location
+       << '/'
+       << std::setw (4) << std::setfill ('0') << year
+       << '-'
+       << std::setw (2) << std::setfill ('0') << month
+       << ".data";
+  auto name = file.str ();
+  auto basename = Path (name).name ();
+
+  // If the datafile is already initialized, return.
+  for (unsigned int i = 0; i < _files.size (); ++i)
+  {
+    if (_files[i].name () == basename)
+    {
+      return i;
+    }
+  }
+
+  // Create the Datafile.
+  Datafile df;
+  df.initialize (name);
+
+  // Insert Datafile into _files. The position is not important. This may move
+  // the other files.
+  _passed.clear ();
+  _files.push_back (df);
+  return _files.size () - 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Called as the scanning iterator moves past a file. The lines of the files
+// passed least recently are released while they exceed the memory budget.
+void Database::passed (Datafile& file)
+{
+  if (! _memoryBudget)
+    return;
+
+  _passed.remove (&file);
+  _passed.push_front (&file);
+
+  size_t total = 0;
+  for (auto& passedFile : _passed)
+    total += passedFile->memory ();
+
+  while (total > _memoryBudget && ! _passed.empty ())
+  {
+    auto oldest = _passed.back ();
+    _passed.pop_back ();
+
+    auto bytes = oldest->memory ();
+    if (oldest->release ())
+      total -= bytes;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The input Daterange has a start and end, for example:
+//
+//   2016-02-20 to 2016-04-15
+//
+// Given the monthly storage scheme, split the Daterange into a vector of
+// segmented Dateranges:
+//
+//   2016-02-01 to 2016-03-01
+//   2016-03-01 to 2016-04-01
+//   2016-04-01 to 2016-05-01
+//
+std::vector <Range> Database::segmentRange (const Range& range)
+{
+  std::vector <Range> segments;
+
+  auto start_y = range.start.year ();
+  auto start_m = range.start.month ();
+
+  auto end = range.end;
+  if (end.toEpoch () == 0)
+  {
+    end = Clock::now ();
+  }
+
+  auto end_y = end.year ();
+  auto end_m = end.month ();
+
+  while (start_y < end_y ||
+         (start_y == end_y && start_m <= end_m))
+  {
+    // Capture date before incrementing month.
+    Datetime segmentStart (start_y, start_m, 1);
+
+    // Next month.
+    start_m += 1;
+    if (start_m > 12)
+    {
+      start_y += 1;
+      start_m = 1;
+    }
+
+    // Capture date after incrementing month.
+    Datetime segmentEnd (start_y, start_m, 1);
+    auto segment = Range (segmentStart, segmentEnd);
+    if (range.intersects (segment))
+    {
+      segments.push_back (segment);
+    }
+  }
+
+  return segments;
+}
+
+bool Database::empty ()
+{
+  return Database::begin () == Database::end ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Database::initializeTagDatabase (bool verbose)
+{
+  clearTags ();
+  Path tags_path (_location + "/tags.data");
+  std::string content;
+  const bool exists = tags_path.exists ();
+  bool loaded = false;
+
+  if (exists && File::read (tags_path, content))
+  {
+    try
+    {
+      std::unique_ptr <json::object> json (dynamic_cast <json::object *>(json::parse (content)));
+
+      if (content.empty () || (json == nullptr))
+      {
+          throw std::string ("Contents invalid.");
+      }
+
+      for (auto &pair : json->_data)
+      {
+        auto key = json::decode (pair.first);
+        auto *value = (json::object *) pair.second;
+        auto iter = value->_data.find ("count");
+
+        if (iter == value->_data.end ())
+        {
+          throw format ("Failed to find \"count\" member for tag \"{1}\" in tags database.", key);
+        }
+
+        auto number = dynamic_cast<json::number *> (iter->second);
+        _tagInfoDatabase.add (key, TagInfo{(unsigned int) number->_dvalue});
+      }
+
+      // Since we just loaded the database from the file, there we can clear the
+      // modified state so that we will not write it back out unless there is a
+      // new change.
+      _tagInfoDatabase.clear_modified ();
+      loaded = true;
+    }
+    catch (const std::string& error)
+    {
+      if (verbose)
+      {
+        std::cerr << "Error parsing tags database: " << error << '\n';
+      }
+    }
+  }
+
+  // The counts do not include the changes made to data files outside of
+  // Timewarrior, so those are counted again, but only written out with the
+  // next change that records the files edited.
+  if (loaded)
+  {
+    if (! editedFiles ().empty ())
+    {
+      recountTags ();
+      _tagInfoDatabase.clear_modified ();
+    }
+
+    return;
+  }
+
+  // We always want the tag database file to exists, but a mounted database is
+  // not written to.
+  clearTags ();
+  if (_source.empty ())
+  {
+    AtomicFile::write (_location + "/tags.data", _tagInfoDatabase.toJson ());
+  }
+
+  auto it = Database::begin ();
+  auto end = Database::end ();
+  
+  if (it == end)
+  {
+    return;
+  }
+
+  if (verbose)
+  {
+    if (!exists)
+    {
+      std::cout << "Tags database does not exist. ";
+    }
+
+    std::cout << "Recreating from interval data..." << std::endl;
+  }
+
+  recountTags ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Database::clearTags ()
+{
+  _tagInfoDatabase = TagInfoDatabase ();
+  _tagInfoDatabase.setSeparator (_tagSeparator);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Database::recountTags ()
+{
+  clearTags ();
+
+  for (auto& line : *this)
+  {
+    Interval interval = IntervalFactory::fromSerialization (line);
+    for (auto& tag : interval.tags ())
+    {
+      _tagInfoDatabase.incrementTag (tag);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Record the checksums of the files written, given those they had when read,
+// and return whether any of them was edited outside of Timewarrior since it
+// was last written. That is so if it was read with other contents than
+// recorded, unless another process wrote and recorded it meanwhile, in which
+// case the recorded contents are those on disk. Files without a checksum yet
+// are recorded as they are.
+bool Database::recordChecksums (const std::vector <std::pair <Datafile*, std::string>>& written)
+{
+  static const std::string empty = contentHash ("");
+
+  loadChecksums ();
+
+  bool edited = false;
+  for (auto& file : written)
+  {
+    auto name = file.first->name ();
+    auto& before = file.second;
+    auto after = file.first->checksum ();
+
+    auto recorded = _checksums.find (name);
+    if (recorded != _checksums.end () &&
+        ! before.empty () &&
+        before != recorded->second)
+    {
+      std::string contents;
+      File::read (file.first->path (), contents);
+      if (contentHash (contents) != recorded->second)
+      {
+        edited = true;
+        _annotationsChanged.insert (name);
+      }
+    }
+
+    if (after == empty)
+    {
+      _checksums.erase (name);
+    }
+    else
+    {
+      _checksums[name] = after;
+    }
+  }
+
+  writeChecksums ();
+  return edited;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The checksums of the data files as last written, 'YYYY-MM.data <hash>' per
+// line. They are read again before each change, as other processes may have
+// recorded theirs.
+void Database::loadChecksums ()
+{
+  _checksums.clear ();
+
+  std::vector <std::string> lines;
+  Path path (_location + "/checksums.data");
+  if (! path.exists () || ! File::read (path, lines))
+  {
+    return;
+  }
+
+  for (auto& line : lines)
+  {
+    auto space = line.find (' ');
+    if (space != std::string::npos)
+    {
+      _checksums[line.substr (0, space)] = line.substr (space + 1);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Database::writeChecksums ()
+{
+  std::vector <std::string> lines;
+  for (auto& checksum : _checksums)
+  {
+    lines.push_back (checksum.first + ' ' + checksum.second);
+  }
+
+  AtomicFile::write (Path (_location + "/checksums.data"), lines);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The data files changed outside of Timewarrior since they were last written,
+// which the tags and the annotation index do not account for. A file with the
+// stamp it was published with is not read. Otherwise, it is edited if its
+// contents differ from the checksum recorded, or if it was removed.
+std::set <std::string> Database::editedFiles ()
+{
+  loadChecksums ();
+  loadStamps ();
+
+  std::set <std::string> edited;
+  for (auto& checksum : _checksums)
+  {
+    auto path = _location + '/' + checksum.first;
+    auto stamp = _stamps.find (checksum.first);
+    if (stamp != _stamps.end () && stamp->second == fileStamp (path))
+    {
+      continue;
+    }
+
+    std::string contents;
+    File::read (path, contents);
+    if (contentHash (contents) != checksum.second)
+    {
+      debug (format ("{1} was edited outside of Timewarrior", checksum.first));
+      edited.insert (checksum.first);
+    }
+  }
+
+  return edited;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The stamps of the data files as published, 'YYYY-MM.data <stamp>' per line.
+// Unlike the checksums, they are only known once the files are in place.
+void Database::loadStamps ()
+{
+  _stamps.clear ();
+
+  std::vector <std::string> lines;
+  Path path (_location + "/stamps.data");
+  if (! path.exists () || ! File::read (path, lines))
+  {
+    return;
+  }
+
+  for (auto& line : lines)
+  {
+    auto space = line.find (' ');
+    if (space != std::string::npos)
+    {
+      _stamps[line.substr (0, space)] = line.substr (space + 1);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Called by publish, under the lock of the generation, once the files are in
+// place. Should this fail, the files are only read again to verify them.
+void Database::recordStamps ()
+{
+  if (_publishing.empty ())
+  {
+    return;
+  }
+
+  loadStamps ();
+  for (auto& stamp : _publishing)
+  {
+    if (stamp.second.empty ())
+    {
+      _stamps.erase (stamp.first);
+    }
+    else
+    {
+      _stamps[stamp.first] = stamp.second;
+    }
+  }
+
+  _publishing.clear ();
+
+  std::vector <std::string> lines;
+  for (auto& stamp : _stamps)
+  {
+    lines.push_back (stamp.first + ' ' + stamp.second);
+  }
+
+  AtomicFile::write (Path (_location + "/stamps.data"), lines);
+  AtomicFile::finalize_all ();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
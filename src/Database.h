@@ -35,6 +35,14 @@
 #include <string>
 #include <TagInfoDatabase.h>
 #include <Journal.h>
+#include <AnnotationIndex.h>
+#include <ChangeLog.h>
+#include <Hooks.h>
+#include <list>
+#include <map>
+#include <memory>
+#include <set>
+#include <utility>
 
 class Database
 {
@@ -48,13 +56,15 @@ public:
     typedef std::vector <std::string>::const_reverse_iterator lines_iterator;
     typedef std::string value_type;
 
+    Database* database;
+
     files_iterator files_it;
     files_iterator files_end;
 
     lines_iterator lines_it;
     lines_iterator lines_end;
 
-    iterator (files_iterator fbegin, files_iterator fend);
+    iterator (Database*, files_iterator fbegin, files_iterator fend);
 
   public:
     iterator& operator++ ();
@@ -94,16 +104,40 @@ public:
 
 public:
   Database () = default;
-  void initialize (const std::string&, Journal& journal);
+  void initialize (const std::string&, Journal& journal, bool verbose = true);
+  void enableAnnotationIndex ();
+  bool hasAnnotationIndex () const;
+  void enableChangeLog ();
+  void enableHooks (const std::string&, unsigned int);
+  void refresh ();
+  std::vector <std::string> changesSince (long long) const;
   void commit ();
-  std::vector <std::string> files () const;
+  void publish (const std::string& = "");
+  void runHooks () const;
+  void snapshot ();
+  std::vector <std::string> files ();
   std::set <std::string> tags () const;
+  const TagInfoDatabase& tagInfoDatabase () const;
+  TagInfoDatabase tagHierarchy () const;
+  void setTagSeparator (const std::string&);
+  void setMemoryBudget (size_t);
+  void mount (const std::string&);
+  std::vector <Database*> mounts () const;
+  const std::string& source () const;
 
   std::string getLatestEntry ();
+  void preload (const Range&);
+  std::vector <std::string> check (unsigned int&, unsigned int&);
 
   void addInterval (const Interval&, bool verbose);
   void deleteInterval (const Interval&);
+  void deleteIntervals (const std::vector <Interval>&);
   void modifyInterval (const Interval&, const Interval &, bool verbose);
+  unsigned int renameTag (const std::string&, const std::string&);
+  unsigned int mergeTags (const std::set <std::string>&, const std::string&);
+  unsigned int purge (const Datetime&);
+
+  std::vector <std::pair <int, std::string>> findAnnotated (const std::vector <std::string>&, const Range&);
 
   std::string dump () const;
 
@@ -115,15 +149,44 @@ public:
 
 private:
   unsigned int getDatafile (int, int);
+  void passed (Datafile&);
   std::vector <Range> segmentRange (const Range&);
   void initializeDatafiles ();
-  void initializeTagDatabase ();
+  void initializeTagDatabase (bool);
+  void clearTags ();
+  unsigned int retag (const std::set <std::string>&, const std::string&, bool);
+  void recountTags ();
+  bool recordChecksums (const std::vector <std::pair <Datafile*, std::string>>&);
+  void loadChecksums ();
+  void writeChecksums ();
+  std::set <std::string> editedFiles ();
+  void loadStamps ();
+  void recordStamps ();
+  void annotationAdded (Datafile&, size_t, const Interval&);
+  void annotationDeleted (Datafile&, size_t);
+  void recordChange (const std::string&, const std::string&);
+  void logChange (const std::string&, const std::string&);
 
 private:
   std::string               _location {"~/.timewarrior/data"};
   std::vector <Datafile>    _files    {};
   TagInfoDatabase           _tagInfoDatabase {};
+  std::string               _tagSeparator {};
   Journal*                  _journal {};
+  bool                      _annotationIndexEnabled {false};
+  AnnotationIndex           _annotationIndex {};
+  std::set <std::string>    _annotationsChanged {};
+  std::set <std::string>    _annotationsUpdated {};
+  ChangeLog                 _changeLog {};
+  Hooks                     _hooks {};
+  bool                      _hooksQueued {false};
+  size_t                    _memoryBudget {0};
+  std::list <Datafile*>     _passed {};
+  std::string               _source {};
+  std::map <std::string, std::string> _checksums {};
+  std::map <std::string, std::string> _stamps {};
+  std::map <std::string, std::string> _publishing {};
+  std::vector <std::shared_ptr <Database>> _mounts {};
 };
 
 #endif
@@ -34,6 +34,15 @@
 #include <stdlib.h>
 #include <AtomicFile.h>
 #include <IntervalFactory.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+
+// The memory held for a line.
+static size_t lineBytes (const std::string& line)
+{
+  return sizeof (std::string) + line.size ();
+}
 
 ////////////////////////////////////////////////////////////////////////////////
 void Datafile::initialize (const std::string& name)
@@ -63,6 +72,38 @@ std::string Datafile::name () const
   return _file.name ();
 }
 
+////////////////////////////////////////////////////////////////////////////////
+std::string Datafile::path () const
+{
+  return _file._data;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const Range& Datafile::range () const
+{
+  return _range;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Datafile::loaded () const
+{
+  return _lines_loaded;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Whether the file has changes that commit will write.
+bool Datafile::dirty () const
+{
+  return _dirty;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Approximate memory held by the loaded lines.
+size_t Datafile::memory () const
+{
+  return _bytes;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Identifies the last incluѕion (^i) lines
 std::string Datafile::lastLine ()
@@ -87,6 +128,145 @@ const std::vector <std::string>& Datafile::allLines ()
   return _lines;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// The position line has, or would have, among the lines once they are sorted
+// as they are written.
+size_t Datafile::sortedPosition (const std::string& line)
+{
+  auto& lines = allLines ();
+  return std::count_if (lines.begin (), lines.end (),
+                        [&line] (const std::string& other) { return other < line; });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Ask the kernel to start reading the file, so that it is in the page cache by
+// the time the lines are loaded.
+void Datafile::prefetch ()
+{
+  if (_lines_loaded || _prefetched)
+    return;
+
+  _prefetched = true;
+
+#ifdef HAVE_POSIX_FADVISE
+  int fd = ::open (_file._data.c_str (), O_RDONLY);
+  if (fd != -1)
+  {
+    ::posix_fadvise (fd, 0, 0, POSIX_FADV_WILLNEED);
+    ::close (fd);
+  }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Load the lines from contents read elsewhere, as load_lines would have read
+// them from the file. The stamp of the file, taken before it was read, tells
+// whether it changed since.
+void Datafile::load (const std::string& contents, const std::string& stamp)
+{
+  if (_lines_loaded)
+    return;
+
+  _checksum = contentHash (contents);
+  _stamp = stamp;
+
+  std::string::size_type start = 0;
+  std::string::size_type end;
+  int count = 0;
+  while (start < contents.size ())
+  {
+    end = contents.find ('\n', start);
+    if (end == std::string::npos)
+      end = contents.size ();
+
+    _lines.push_back (contents.substr (start, end - start));
+    _bytes += lineBytes (_lines.back ());
+    start = end + 1;
+    ++count;
+  }
+
+  // The lines as they are in the file, as long as it is sorted and consists
+  // of nothing but lines.
+  _unchanged = count;
+  if (! std::is_sorted (_lines.begin (), _lines.end ()) ||
+      (count && contents.back () != '\n'))
+    _unchanged = 0;
+
+  // Skip a byte order mark.
+  if (count && _lines[_lines.size () - count].compare (0, 3, "\xEF\xBB\xBF") == 0)
+  {
+    _lines[_lines.size () - count].erase (0, 3);
+    _unchanged = 0;
+  }
+
+  _lines_loaded = true;
+  debug (format ("{1}: {2} intervals", _file.name (), count));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Drop the loaded lines, which are read again when next needed. Files changed
+// in this run are kept, as their lines may not be written out yet.
+bool Datafile::release ()
+{
+  if (! _lines_loaded || _modified)
+    return false;
+
+  std::vector <std::string> ().swap (_lines);
+  _bytes        = 0;
+  _lines_loaded = false;
+  _prefetched   = false;
+
+  debug (format ("{1}: Released", _file.name ()));
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Drop the loaded lines if another process changed the file since they were
+// read, so that they are read again. Files changed in this run are kept.
+bool Datafile::refresh ()
+{
+  if (! _lines_loaded || _modified || fileStamp (_file._data) == _stamp)
+    return false;
+
+  return release ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Open the file now, and read its lines from this descriptor when they are
+// needed, so that they are those of the file as it is now, even after it has
+// been replaced. A file that does not exist now has no lines.
+bool Datafile::pin ()
+{
+  if (_lines_loaded || _pinned)
+    return true;
+
+  int fd = ::open (_file._data.c_str (), O_RDONLY);
+  if (fd == -1 && errno != ENOENT)
+    return false;
+
+  _pinned = std::shared_ptr <int> (new int (fd), [] (int* descriptor)
+  {
+    if (*descriptor != -1)
+      ::close (*descriptor);
+
+    delete descriptor;
+  });
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Datafile::unpin ()
+{
+  _pinned.reset ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Datafile::pinned () const
+{
+  return _pinned != nullptr;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Accepted intervals;   day1 <= interval.start < dayN
 void Datafile::addInterval (const Interval& interval)
@@ -111,9 +291,16 @@ void Datafile::addInterval (const Interval& interval)
                      interval.dump (), test.dump ()));
     }
 
+    // Lines are sorted when written, so a line that sorts before the
+    // unchanged ones changes where they are in the file.
+    auto unchanged = _lines.begin () + _unchanged;
+    _unchanged = std::lower_bound (_lines.begin (), unchanged, serialization) - _lines.begin ();
+
     _lines.push_back (serialization);
     debug (format ("{1}: Added {2}", _file.name (), _lines.back ()));
+    _bytes += lineBytes (serialization);
     _dirty = true;
+    _modified = true;
   }
   catch (const std::string& error)
   {
@@ -140,18 +327,121 @@ void Datafile::deleteInterval (const Interval& interval)
     throw format ("Datafile::deleteInterval failed to find '{1}'", serialized);
   }
 
+  _unchanged = std::min (_unchanged, static_cast <size_t> (i - _lines.begin ()));
+  _bytes -= lineBytes (*i);
   _lines.erase (i);
   _dirty = true;
+  _modified = true;
   debug (format ("{1}: Deleted {2}", _file.name (), serialized));
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Delete several intervals in one pass over the lines.
+void Datafile::deleteIntervals (const std::vector <Interval>& intervals)
+{
+  if (! _lines_loaded)
+  {
+    load_lines ();
+  }
+
+  std::multiset <std::string> serialized;
+  for (auto& interval : intervals)
+  {
+    assert (interval.startsWithin (_range));
+    serialized.insert (interval.serialize ());
+  }
+
+  // Nothing is deleted unless all are found.
+  auto missing = serialized;
+  for (auto& line : _lines)
+  {
+    auto match = missing.find (line);
+    if (match != missing.end ())
+    {
+      missing.erase (match);
+    }
+  }
+
+  if (! missing.empty ())
+  {
+    throw format ("Datafile::deleteIntervals failed to find '{1}'", *missing.begin ());
+  }
+
+  size_t kept = 0;
+  for (size_t i = 0; i < _lines.size (); ++i)
+  {
+    auto match = serialized.find (_lines[i]);
+    if (match != serialized.end ())
+    {
+      serialized.erase (match);
+      _unchanged = std::min (_unchanged, i);
+      _bytes -= lineBytes (_lines[i]);
+      debug (format ("{1}: Deleted {2}", _file.name (), _lines[i]));
+      continue;
+    }
+
+    if (kept != i)
+    {
+      _lines[kept] = std::move (_lines[i]);
+    }
+
+    ++kept;
+  }
+
+  _lines.resize (kept);
+  _dirty = true;
+  _modified = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Replace the line at index of allLines by that of interval, which must start
+// at the same time.
+void Datafile::replaceInterval (size_t index, const Interval& interval)
+{
+  assert (_lines_loaded && index < _lines.size ());
+
+  auto serialization = interval.serialize ();
+  auto unchanged = _lines.begin () + std::min (_unchanged, index);
+  _unchanged = std::lower_bound (_lines.begin (), unchanged, serialization) - _lines.begin ();
+
+  _bytes -= lineBytes (_lines[index]);
+  _bytes += lineBytes (serialization);
+  debug (format ("{1}: Replaced {2}", _file.name (), _lines[index]));
+  _lines[index] = serialization;
+  _dirty = true;
+  _modified = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Drop all intervals, so that the file is removed on commit.
+void Datafile::clear ()
+{
+  std::vector <std::string> ().swap (_lines);
+  _bytes        = 0;
+  _unchanged    = 0;
+  _lines_loaded = true;
+  _dirty        = true;
+  _modified     = true;
+  debug (format ("{1}: Cleared", _file.name ()));
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void Datafile::commit ()
 {
   // The _dirty flag indicates that the file needs to be written.
   if (_dirty)
   {
+    // Writing over the changes of another process since the file was read
+    // would lose them.
+    if (fileStamp (_file._data) != _stamp)
+    {
+      throw format ("The data file '{1}' was changed by another process. No changes were written.", _file._data);
+    }
+
     AtomicFile file (_file);
+    file.expect (_stamp);
+    _written = true;
+
     if (_lines.size () > 0)
     {
       if (file.open ())
@@ -159,13 +449,35 @@ void Datafile::commit ()
         // Sort the intervals by ascending start time.
         std::sort (_lines.begin (), _lines.end ());
 
-        // Write out all the lines.
-        file.truncate ();
+        // The checksum is that of the whole file as written.
+        std::string content;
         for (auto& line : _lines)
+          content += line + '\n';
+
+        _checksum = contentHash (content);
+
+        if (_unchanged > 0)
+        {
+          // Only rewrite the lines after the unchanged ones, as when the open
+          // interval is stopped or replaced.
+          size_t offset = 0;
+          for (size_t i = 0; i < _unchanged; ++i)
+            offset += _lines[i].size () + 1;
+
+          std::string tail;
+          for (size_t i = _unchanged; i < _lines.size (); ++i)
+            tail += _lines[i] + '\n';
+
+          file.replace_tail (offset, tail);
+        }
+        else
         {
-          file.write_raw (line + '\n');
+          // Write out all the lines.
+          file.truncate ();
+          file.write_raw (content);
         }
 
+        _unchanged = _lines.size ();
         _dirty = false;
       }
       else
@@ -176,10 +488,31 @@ void Datafile::commit ()
     else
     {
       file.remove ();
+      _checksum = contentHash ("");
     }
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Once the file written by commit has replaced the old one, it is the file as
+// read. Returns whether there was such a file.
+bool Datafile::published ()
+{
+  if (! _written)
+    return false;
+
+  _stamp = fileStamp (_file._data);
+  _written = false;
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The checksum of the file as last read or written, empty if it was neither.
+const std::string& Datafile::checksum () const
+{
+  return _checksum;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 std::string Datafile::dump () const
 {
@@ -198,20 +531,33 @@ std::string Datafile::dump () const
 ////////////////////////////////////////////////////////////////////////////////
 void Datafile::load_lines ()
 {
+  if (_pinned)
+  {
+    std::string contents;
+    char buffer[65536];
+    off_t offset = 0;
+    ssize_t count;
+    while (*_pinned != -1 &&
+           (count = ::pread (*_pinned, buffer, sizeof (buffer), offset)) > 0)
+    {
+      contents.append (buffer, count);
+      offset += count;
+    }
+
+    load (contents, fileStamp (*_pinned));
+    return;
+  }
+
+  auto stamp = fileStamp (_file._data);
   AtomicFile file (_file);
   if (file.open ())
   {
     // Load the data.
-    std::vector <std::string> read_lines;
-    file.read (read_lines);
+    std::string contents;
+    file.read (contents);
     file.close ();
 
-    // Append the lines that were read.
-    for (auto& line : read_lines)
-      _lines.push_back (line);
-
-    _lines_loaded = true;
-    debug (format ("{1}: {2} intervals", file.name (), read_lines.size ()));
+    load (contents, stamp);
   }
 }
 
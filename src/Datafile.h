@@ -30,6 +30,7 @@
 #include <Interval.h>
 #include <Range.h>
 #include <FS.h>
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -39,13 +40,31 @@ public:
   Datafile () = default;
   void initialize (const std::string&);
   std::string name () const;
+  std::string path () const;
+  const Range& range () const;
+  bool loaded () const;
+  bool dirty () const;
+  const std::string& checksum () const;
+  size_t memory () const;
 
   std::string lastLine ();
   const std::vector <std::string>& allLines ();
+  size_t sortedPosition (const std::string&);
+  void prefetch ();
+  void load (const std::string&, const std::string&);
+  bool release ();
+  bool refresh ();
+  bool pin ();
+  void unpin ();
+  bool pinned () const;
 
   void addInterval (const Interval&);
   void deleteInterval (const Interval&);
+  void deleteIntervals (const std::vector <Interval>&);
+  void replaceInterval (size_t, const Interval&);
+  void clear ();
   void commit ();
+  bool published ();
 
   std::string dump () const;
 
@@ -57,7 +76,15 @@ private:
   bool                      _dirty        {false};
   std::vector <std::string> _lines        {};
   bool                      _lines_loaded {false};
+  bool                      _prefetched   {false};
+  bool                      _modified     {false};
+  size_t                    _bytes        {0};
+  size_t                    _unchanged    {0};
+  std::string               _stamp        {};
+  bool                      _written      {false};
+  std::shared_ptr <int>     _pinned       {};
   Range                     _range        {};
+  std::string               _checksum     {};
 };
 
 #endif
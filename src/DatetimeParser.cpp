@@ -26,6 +26,7 @@
 
 #include <cmake.h>
 #include <DatetimeParser.h>
+#include <Clock.h>
 #include <algorithm>
 #include <iostream>
 #include <sstream>
@@ -1045,7 +1046,7 @@ bool DatetimeParser::initializeNow (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      _date = time (nullptr);
+      _date = Clock::now ().toEpoch ();
       return true;
     }
   }
@@ -1068,7 +1069,7 @@ bool DatetimeParser::initializeYesterday (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
@@ -1097,7 +1098,7 @@ bool DatetimeParser::initializeToday (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
@@ -1126,7 +1127,7 @@ bool DatetimeParser::initializeTomorrow (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_mday++;
@@ -1170,7 +1171,7 @@ bool DatetimeParser::initializeOrdinal (Pig& pig)
             remainder1 == 0 ||
             remainder1 > 3) && character1 == 't' && character2 == 'h'))
       {
-        time_t now = time (nullptr);
+        time_t now = Clock::now ().toEpoch ();
         struct tm* t = localtime (&now);
 
         int y = t->tm_year + 1900;
@@ -1229,7 +1230,7 @@ bool DatetimeParser::initializeDayName (Pig& pig)
           following != ':' &&
           following != '=')
       {
-        time_t now = time (nullptr);
+        time_t now = Clock::now ().toEpoch ();
         struct tm* t = localtime (&now);
 
         if (t->tm_wday >= day)
@@ -1272,7 +1273,7 @@ bool DatetimeParser::initializeMonthName (Pig& pig)
           following != ':' &&
           following != '=')
       {
-        time_t now = time (nullptr);
+        time_t now = Clock::now ().toEpoch ();
         struct tm* t = localtime (&now);
 
         if (t->tm_mon >= month && Datetime::timeRelative)
@@ -1315,7 +1316,7 @@ bool DatetimeParser::initializeLater (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
@@ -1344,7 +1345,7 @@ bool DatetimeParser::initializeSopd (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
@@ -1371,7 +1372,7 @@ bool DatetimeParser::initializeSod (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
@@ -1397,7 +1398,7 @@ bool DatetimeParser::initializeSond (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_mday++;
@@ -1424,7 +1425,7 @@ bool DatetimeParser::initializeEopd (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
@@ -1450,7 +1451,7 @@ bool DatetimeParser::initializeEod (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_mday++;
@@ -1477,7 +1478,7 @@ bool DatetimeParser::initializeEond (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_mday += 2;
@@ -1504,7 +1505,7 @@ bool DatetimeParser::initializeSopw (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
       t->tm_hour = t->tm_min = t->tm_sec = 0;
 
@@ -1534,7 +1535,7 @@ bool DatetimeParser::initializeSow (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
       t->tm_hour = t->tm_min = t->tm_sec = 0;
 
@@ -1563,7 +1564,7 @@ bool DatetimeParser::initializeSonw (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
       t->tm_hour = t->tm_min = t->tm_sec = 0;
 
@@ -1593,7 +1594,7 @@ bool DatetimeParser::initializeEopw (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
       t->tm_hour = t->tm_min = t->tm_sec = 0;
 
@@ -1622,7 +1623,7 @@ bool DatetimeParser::initializeEow (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
       t->tm_hour = t->tm_min = t->tm_sec = 0;
 
@@ -1652,7 +1653,7 @@ bool DatetimeParser::initializeEonw (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_mday += 15 - t->tm_wday;
@@ -1679,7 +1680,7 @@ bool DatetimeParser::initializeSopww (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_mday += -6 - t->tm_wday;
@@ -1706,7 +1707,7 @@ bool DatetimeParser::initializeSoww (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_mday += 8 - t->tm_wday;
@@ -1733,7 +1734,7 @@ bool DatetimeParser::initializeSonww (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_mday += 8 - t->tm_wday;
@@ -1760,7 +1761,7 @@ bool DatetimeParser::initializeEopww (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_mday -= (t->tm_wday + 1) % 7;
@@ -1787,7 +1788,7 @@ bool DatetimeParser::initializeEoww (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_mday += 6 - t->tm_wday;
@@ -1814,7 +1815,7 @@ bool DatetimeParser::initializeEonww (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_mday += 13 - t->tm_wday;
@@ -1841,7 +1842,7 @@ bool DatetimeParser::initializeSopm (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
@@ -1877,7 +1878,7 @@ bool DatetimeParser::initializeSom (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
@@ -1904,7 +1905,7 @@ bool DatetimeParser::initializeSonm (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
@@ -1939,7 +1940,7 @@ bool DatetimeParser::initializeEopm (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
@@ -1966,7 +1967,7 @@ bool DatetimeParser::initializeEom (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
@@ -2001,7 +2002,7 @@ bool DatetimeParser::initializeEonm (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
@@ -2035,7 +2036,7 @@ bool DatetimeParser::initializeSopq (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_mon -= t->tm_mon % 3;
@@ -2070,7 +2071,7 @@ bool DatetimeParser::initializeSoq (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
@@ -2098,7 +2099,7 @@ bool DatetimeParser::initializeSonq (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_mon += 3 - (t->tm_mon % 3);
@@ -2132,7 +2133,7 @@ bool DatetimeParser::initializeEopq (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
@@ -2160,7 +2161,7 @@ bool DatetimeParser::initializeEoq (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_mon += 3 - (t->tm_mon % 3);
@@ -2194,7 +2195,7 @@ bool DatetimeParser::initializeEonq (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
@@ -2228,7 +2229,7 @@ bool DatetimeParser::initializeSopy (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
@@ -2257,7 +2258,7 @@ bool DatetimeParser::initializeSoy (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
@@ -2285,7 +2286,7 @@ bool DatetimeParser::initializeSony (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
@@ -2314,7 +2315,7 @@ bool DatetimeParser::initializeEopy (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
@@ -2342,7 +2343,7 @@ bool DatetimeParser::initializeEoy (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
@@ -2371,7 +2372,7 @@ bool DatetimeParser::initializeEony (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       t->tm_hour = t->tm_min = t->tm_sec = 0;
@@ -2408,7 +2409,7 @@ bool DatetimeParser::initializeEaster (Pig& pig)
         ! unicodeLatinAlpha (pig.peek ()) &&
         ! unicodeLatinDigit (pig.peek ()))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       easter (t);
@@ -2446,7 +2447,7 @@ bool DatetimeParser::initializeMidsommar (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
       midsommar (t);
       _date = mktime (t);
@@ -2482,7 +2483,7 @@ bool DatetimeParser::initializeMidsommarafton (Pig& pig)
     if (! unicodeLatinAlpha (following) &&
         ! unicodeLatinDigit (following))
     {
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
       midsommarafton (t);
       _date = mktime (t);
@@ -2586,7 +2587,7 @@ bool DatetimeParser::initializeInformalTime (Pig& pig)
     if (haveDesignator || ! needDesignator)
     {
       // Midnight today + hours:minutes:seconds.
-      time_t now = time (nullptr);
+      time_t now = Clock::now ().toEpoch ();
       struct tm* t = localtime (&now);
 
       int now_seconds  = (t->tm_hour * 3600) + (t->tm_min * 60) + t->tm_sec;
@@ -2832,7 +2833,7 @@ void DatetimeParser::resolve ()
   bool utc    = _utc;
 
   // Get current time.
-  time_t now = time (nullptr);
+  time_t now = Clock::now ().toEpoch ();
 
   // A UTC offset needs to be accommodated.  Once the offset is subtracted,
   // only local and UTC times remain.
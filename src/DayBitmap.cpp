@@ -0,0 +1,207 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <DayBitmap.h>
+#include <timew.h>
+#include <algorithm>
+#include <bitset>
+#include <cassert>
+
+static const uint64_t allBits = ~static_cast <uint64_t> (0);
+
+////////////////////////////////////////////////////////////////////////////////
+// The bitmap of the day containing the given time, with no seconds set.
+DayBitmap::DayBitmap (const Datetime& datetime)
+{
+  auto day = getFullDay (datetime);
+  _start = day.start.toEpoch ();
+  _end   = day.end.toEpoch ();
+  _words.resize ((_end - _start + 63) / 64, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Range DayBitmap::day () const
+{
+  return Range (Datetime (_start), Datetime (_end));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A closed range that lies entirely within the day.
+bool DayBitmap::covers (const Range& range) const
+{
+  return range.is_started () &&
+         range.is_ended () &&
+         range.start.toEpoch () >= _start &&
+         range.end.toEpoch () <= _end;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Set the seconds of the range that fall within the day. An open range extends
+// to the end of the day.
+void DayBitmap::set (const Range& range)
+{
+  fill (range, true);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void DayBitmap::clear (const Range& range)
+{
+  fill (range, false);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DayBitmap& DayBitmap::operator|= (const DayBitmap& other)
+{
+  assert (_start == other._start);
+
+  for (unsigned int i = 0; i < _words.size (); ++i)
+    _words[i] |= other._words[i];
+
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DayBitmap& DayBitmap::operator&= (const DayBitmap& other)
+{
+  assert (_start == other._start);
+
+  for (unsigned int i = 0; i < _words.size (); ++i)
+    _words[i] &= other._words[i];
+
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+DayBitmap& DayBitmap::subtract (const DayBitmap& other)
+{
+  assert (_start == other._start);
+
+  for (unsigned int i = 0; i < _words.size (); ++i)
+    _words[i] &= ~other._words[i];
+
+  return *this;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool DayBitmap::empty () const
+{
+  return std::all_of (_words.begin (), _words.end (), [] (uint64_t word) { return word == 0; });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Number of seconds set.
+time_t DayBitmap::count () const
+{
+  time_t total = 0;
+  for (auto& word : _words)
+    total += std::bitset <64> (word).count ();
+
+  return total;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The runs of set seconds, as ranges in ascending order. Adjacent seconds are
+// always part of the same range.
+std::vector <Range> DayBitmap::ranges () const
+{
+  std::vector <Range> results;
+  bool inside = false;
+  time_t run = 0;
+
+  for (unsigned int i = 0; i < _words.size (); ++i)
+  {
+    auto word = _words[i];
+
+    // Whole words that do not end or start a run are skipped.
+    if ((! inside && word == 0) ||
+        (inside && word == allBits))
+      continue;
+
+    for (unsigned int bit = 0; bit < 64; ++bit)
+    {
+      bool set = (word >> bit) & 1;
+      if (set != inside)
+      {
+        time_t second = _start + i * 64 + bit;
+        if (set)
+          run = second;
+        else
+          results.push_back (Range (Datetime (run), Datetime (second)));
+
+        inside = set;
+      }
+    }
+  }
+
+  if (inside)
+    results.push_back (Range (Datetime (run), Datetime (_end)));
+
+  return results;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Bits beyond the end of the day are never set, as the range is clipped.
+void DayBitmap::fill (const Range& range, bool value)
+{
+  if (! range.is_started ())
+    return;
+
+  time_t from = std::max (range.start.toEpoch (), _start);
+  time_t to   = range.is_ended () ? std::min (range.end.toEpoch (), _end) : _end;
+  if (from >= to)
+    return;
+
+  auto first = from - _start;
+  auto last  = to - _start - 1;
+
+  auto firstWord = first / 64;
+  auto lastWord  = last / 64;
+  uint64_t head = allBits << (first % 64);
+  uint64_t tail = allBits >> (63 - last % 64);
+
+  auto apply = [&] (uint64_t& word, uint64_t mask)
+  {
+    if (value)
+      word |= mask;
+    else
+      word &= ~mask;
+  };
+
+  if (firstWord == lastWord)
+  {
+    apply (_words[firstWord], head & tail);
+    return;
+  }
+
+  apply (_words[firstWord], head);
+  for (auto i = firstWord + 1; i < lastWord; ++i)
+    _words[i] = value ? allBits : 0;
+
+  apply (_words[lastWord], tail);
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,68 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_DAYBITMAP
+#define INCLUDED_DAYBITMAP
+
+#include <Datetime.h>
+#include <Range.h>
+#include <cstdint>
+#include <ctime>
+#include <vector>
+
+// The seconds of one day as a bitmap, one bit per second, so that unions,
+// differences and totals of ranges within the day are word-wide operations
+// rather than Range algebra. A day is midnight to midnight local time, which
+// may be 23 or 25 hours long.
+class DayBitmap
+{
+public:
+  explicit DayBitmap (const Datetime&);
+
+  Range day () const;
+  bool covers (const Range&) const;
+
+  void set (const Range&);
+  void clear (const Range&);
+
+  DayBitmap& operator|= (const DayBitmap&);
+  DayBitmap& operator&= (const DayBitmap&);
+  DayBitmap& subtract (const DayBitmap&);
+
+  bool empty () const;
+  time_t count () const;
+  std::vector <Range> ranges () const;
+
+private:
+  void fill (const Range&, bool);
+
+private:
+  time_t                  _start {0};
+  time_t                  _end   {0};
+  std::vector <uint64_t>  _words {};
+};
+
+#endif
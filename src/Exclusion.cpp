@@ -26,6 +26,7 @@
 
 #include <cmake.h>
 #include <Exclusion.h>
+#include <Clock.h>
 #include <Datetime.h>
 #include <Pig.h>
 #include <shared.h>
@@ -125,7 +126,7 @@ std::vector <Range> Exclusion::ranges (const Range& range) const
 
     if (myRange.is_open())
     {
-      myRange.end = Datetime();
+      myRange.end = Clock::now ();
     }
 
     while (start <= myRange.end)
@@ -0,0 +1,125 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <Generation.h>
+#include <FS.h>
+#include <format.h>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+
+////////////////////////////////////////////////////////////////////////////////
+Generation::Generation (const std::string& path)
+: _path (path)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A generation that is not ended stays odd, as after a failed commit.
+Generation::~Generation ()
+{
+  unlock ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A missing file is generation 0.
+unsigned long Generation::read () const
+{
+  std::string content;
+  if (! File::read (_path, content))
+    return 0;
+
+  return strtoul (content.c_str (), NULL, 10);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A commit begins, once no other is in progress. If an earlier commit failed,
+// the generation is odd already.
+void Generation::begin ()
+{
+  lock ();
+  write (read () | 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Also ends the generation of a failed commit, which was never begun here.
+void Generation::end ()
+{
+  lock ();
+  write ((read () | 1) + 1);
+  unlock ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The lock is on a file of its own, as the generation file is replaced.
+void Generation::lock ()
+{
+  if (_lock != -1)
+    return;
+
+  auto path = _path + ".lock";
+  _lock = ::open (path.c_str (), O_RDWR | O_CREAT, 0600);
+  if (_lock == -1)
+    throw format ("Could not open '{1}': {2}", path, strerror (errno));
+
+  while (::flock (_lock, LOCK_EX) != 0)
+  {
+    if (errno != EINTR)
+    {
+      unlock ();
+      throw format ("Could not lock '{1}': {2}", path, strerror (errno));
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Generation::unlock ()
+{
+  if (_lock != -1)
+  {
+    ::close (_lock);
+    _lock = -1;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The new value replaces the old one by rename, so it is never seen partially.
+void Generation::write (unsigned long value)
+{
+  auto temp = _path + ".tmp";
+  if (! File::write (temp, std::to_string (value) + '\n') ||
+      ::rename (temp.c_str (), _path.c_str ()) != 0)
+  {
+    throw format ("Could not write to '{1}'", _path);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
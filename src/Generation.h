@@ -0,0 +1,58 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_GENERATION
+#define INCLUDED_GENERATION
+
+#include <string>
+
+// The generation of the database, a counter kept in its own file. It is odd
+// while a commit replaces data files, and even otherwise. A reader that sees
+// the same even generation before and after opening the data files has opened
+// one consistent version of them. Writers hold a lock from begin to end, so
+// that one cannot end a generation while another is still replacing files.
+class Generation
+{
+public:
+  explicit Generation (const std::string&);
+  Generation (const Generation&) = delete;
+  Generation& operator= (const Generation&) = delete;
+  ~Generation ();
+  unsigned long read () const;
+  void begin ();
+  void end ();
+
+private:
+  void lock ();
+  void unlock ();
+  void write (unsigned long);
+
+private:
+  std::string _path;
+  int         _lock {-1};
+};
+
+#endif
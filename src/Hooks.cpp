@@ -0,0 +1,351 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <Hooks.h>
+#include <Clock.h>
+#include <FS.h>
+#include <format.h>
+#include <shared.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// A script that failed this often on the same batch has it moved aside.
+static const unsigned int maxAttempts = 5;
+
+////////////////////////////////////////////////////////////////////////////////
+// The scripts in <location>/hooks named 'on-commit*' are run, with at most
+// batch queued commands at a time.
+void Hooks::initialize (const std::string& location, unsigned int batch)
+{
+  _scripts.clear ();
+  _spool = location + "/spool";
+  _batch = std::max (batch, 1u);
+
+  Directory hooks (location + "/hooks");
+  if (hooks.is_directory ())
+  {
+    for (auto& script : hooks.list ())
+    {
+      if (Path (script).name ().compare (0, 9, "on-commit") == 0 &&
+          Path (script).executable ())
+      {
+        _scripts.push_back (script);
+      }
+    }
+
+    std::sort (_scripts.begin (), _scripts.end ());
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Hooks::enabled () const
+{
+  return ! _scripts.empty ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void Hooks::record (const std::string& before, const std::string& after)
+{
+  if (enabled ())
+  {
+    _changes.push_back ("{\"before\":" + (before.empty () ? std::string ("null") : before) +
+                        ",\"after\":" + (after.empty () ? std::string ("null") : after) + "}");
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Queue the changes recorded since the last call as one line, in a file named
+// so that sorting the spool by name sorts it by time. The file appears by
+// rename, so that the worker never reads it partially. Returns whether there
+// was anything to queue.
+bool Hooks::enqueue ()
+{
+  if (_changes.empty ())
+  {
+    return false;
+  }
+
+  Directory spool (_spool);
+  if (! spool.exists ())
+  {
+    spool.create (0700);
+  }
+
+  auto now = std::chrono::duration_cast <std::chrono::microseconds> (
+    std::chrono::system_clock::now ().time_since_epoch ()).count ();
+  auto name = std::to_string (now);
+  name.insert (0, name.length () < 20 ? 20 - name.length () : 0, '0');
+
+  auto path = _spool + "/" + name + "-" + std::to_string (::getpid ()) + ".data";
+  auto temp = path + ".tmp";
+
+  auto line = "{\"time\":\"" + Clock::now ().toISO () + "\",\"changes\":[" + join (",", _changes) + "]}\n";
+  if (! File::write (temp, line) ||
+      ::rename (temp.c_str (), path.c_str ()) != 0)
+  {
+    throw format ("Could not write to '{1}'", path);
+  }
+
+  _changes.clear ();
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Drain the spool in a detached process, which outlives this one and does not
+// hold its terminal. If it cannot be started, the queue is drained after the
+// next command.
+void Hooks::start () const
+{
+  if (! enabled ())
+  {
+    return;
+  }
+
+  auto pid = ::fork ();
+  if (pid == 0)
+  {
+    if (::setsid () != -1 && ::fork () == 0)
+    {
+      auto null = ::open ("/dev/null", O_RDWR);
+      if (null != -1)
+      {
+        ::dup2 (null, STDIN_FILENO);
+        ::dup2 (null, STDOUT_FILENO);
+        ::dup2 (null, STDERR_FILENO);
+        if (null > STDERR_FILENO)
+        {
+          ::close (null);
+        }
+      }
+
+      try
+      {
+        drain ();
+      }
+
+      catch (...)
+      {
+      }
+    }
+
+    ::_exit (0);
+  }
+
+  if (pid > 0)
+  {
+    ::waitpid (pid, nullptr, 0);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Deliver all queued commands. Only one worker drains the spool at a time; a
+// command that queues while another worker holds the lock leaves its line to
+// that worker, which therefore looks again after releasing the lock.
+void Hooks::drain () const
+{
+  auto lock = ::open ((_spool + "/lock").c_str (), O_CREAT | O_RDWR, 0600);
+  if (lock == -1)
+  {
+    return;
+  }
+
+  while (::flock (lock, LOCK_EX | LOCK_NB) == 0)
+  {
+    bool delivered = deliver ();
+    ::flock (lock, LOCK_UN);
+
+    if (! delivered || pending ().empty ())
+    {
+      break;
+    }
+  }
+
+  ::close (lock);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::vector <std::string> Hooks::pending () const
+{
+  std::vector <std::string> files;
+
+  Directory spool (_spool);
+  if (spool.is_directory ())
+  {
+    for (auto& file : spool.list ())
+    {
+      if (file.length () > 5 && file.compare (file.length () - 5, 5, ".data") == 0)
+      {
+        files.push_back (file);
+      }
+    }
+
+    std::sort (files.begin (), files.end ());
+  }
+
+  return files;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Pass the queued commands, oldest first, to every script, one line each. Each
+// script has a cursor in the spool, '<script>.cursor', holding the name of the
+// last queued file it accepted and how often it failed on the files after it.
+// A failing script leaves its cursor where it is, to be passed the same batch
+// by the next worker, while the other scripts carry on. After maxAttempts
+// failures, the batch is moved to 'failed' in the spool for that script, and
+// its cursor moves past it. Queued files are removed once every script has
+// accepted them.
+bool Hooks::deliver () const
+{
+  auto files = pending ();
+  bool delivered = true;
+
+  std::vector <std::string> cursors;
+  for (auto& script : _scripts)
+  {
+    auto cursor = _spool + '/' + Path (script).name () + ".cursor";
+
+    std::string last;
+    unsigned int failures = 0;
+    readCursor (cursor, last, failures);
+
+    auto next = std::upper_bound (files.begin (), files.end (), _spool + '/' + last);
+
+    while (next != files.end ())
+    {
+      auto end = next + std::min (static_cast <size_t> (_batch),
+                                  static_cast <size_t> (files.end () - next));
+
+      std::string input;
+      for (auto file = next; file != end; ++file)
+      {
+        std::string line;
+        if (File::read (*file, line))
+        {
+          input += line;
+        }
+      }
+
+      std::string output;
+      if (execute (script, {}, input, output) == 0)
+      {
+        failures = 0;
+      }
+      else if (++failures < maxAttempts)
+      {
+        writeCursor (cursor, last, failures);
+        delivered = false;
+        break;
+      }
+      else
+      {
+        moveAside (script, Path (*next).name (), input);
+        failures = 0;
+      }
+
+      last = Path (*(end - 1)).name ();
+      writeCursor (cursor, last, failures);
+      next = end;
+    }
+
+    cursors.push_back (last);
+  }
+
+  // Only the files that all scripts accepted are removed.
+  auto oldest = *std::min_element (cursors.begin (), cursors.end ());
+  for (auto& file : files)
+  {
+    if (oldest.empty () || Path (file).name () > oldest)
+    {
+      break;
+    }
+
+    if (! File::remove (file))
+    {
+      return false;
+    }
+  }
+
+  return delivered;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A cursor is '<last file accepted> <failures>'. Without one, the script has
+// accepted nothing yet.
+void Hooks::readCursor (const std::string& path, std::string& last, unsigned int& failures) const
+{
+  last.clear ();
+  failures = 0;
+
+  std::string content;
+  if (File::read (path, content))
+  {
+    auto space = content.find (' ');
+    if (space != std::string::npos)
+    {
+      last = content.substr (0, space);
+      failures = static_cast <unsigned int> (std::strtoul (content.c_str () + space + 1, nullptr, 10));
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The cursor is replaced by rename, so that it is never read partially.
+void Hooks::writeCursor (const std::string& path, const std::string& last, unsigned int failures) const
+{
+  auto temp = path + ".tmp";
+  if (! File::write (temp, last + ' ' + std::to_string (failures) + '\n') ||
+      ::rename (temp.c_str (), path.c_str ()) != 0)
+  {
+    throw format ("Could not write to '{1}'", path);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Keep a batch that a script kept failing on, as it was passed, named after
+// the script and the first queued file of the batch.
+void Hooks::moveAside (const std::string& script, const std::string& first, const std::string& input) const
+{
+  Directory failed (_spool + "/failed");
+  if (! failed.exists ())
+  {
+    failed.create (0700);
+  }
+
+  auto path = failed._data + '/' + Path (script).name () + '-' + first;
+  if (! File::write (path, input))
+  {
+    throw format ("Could not write to '{1}'", path);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
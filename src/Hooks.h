@@ -0,0 +1,60 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_HOOKS
+#define INCLUDED_HOOKS
+
+#include <string>
+#include <vector>
+
+// Post-commit hooks. The changes of each command are queued as one line in a
+// spool directory once committed, and a detached worker passes them in batches
+// to the 'on-commit' scripts, so that a command does not wait for its hooks.
+class Hooks
+{
+public:
+  void initialize (const std::string&, unsigned int);
+  bool enabled () const;
+
+  void record (const std::string&, const std::string&);
+  bool enqueue ();
+  void start () const;
+  void drain () const;
+
+private:
+  std::vector <std::string> pending () const;
+  bool deliver () const;
+  void readCursor (const std::string&, std::string&, unsigned int&) const;
+  void writeCursor (const std::string&, const std::string&, unsigned int) const;
+  void moveAside (const std::string&, const std::string&, const std::string&) const;
+
+  std::vector <std::string> _scripts {};
+  std::string               _spool   {};
+  unsigned int              _batch   {0};
+  std::vector <std::string> _changes {};
+};
+
+#endif
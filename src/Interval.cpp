@@ -155,6 +155,11 @@ std::string Interval::json () const
     {
       out << ",\"annotation\":\"" << json::encode (annotation) << "\"";
     }
+
+    if (!source.empty ())
+    {
+      out << ",\"source\":\"" << json::encode (source) << "\"";
+    }
   }
   out << "}";
 
@@ -187,6 +192,9 @@ std::string Interval::dump () const
   if (synthetic)
     out << " synthetic";
 
+  if (! source.empty ())
+    out << " from " << source;
+
   return out.str ();
 }
 
@@ -59,6 +59,7 @@ public:
   int                    id        {0};
   bool                   synthetic {false};
   std::string            annotation {};
+  std::string            source    {};
 
 private:
   std::set <std::string> _tags  {};
@@ -24,11 +24,15 @@
 //
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <cassert>
 #include <AtomicFile.h>
+#include <Clock.h>
 #include <format.h>
+#include <IntervalFactory.h>
 #include <Journal.h>
 #include <TransactionsFactory.h>
+#include <shared.h>
 
 #include <timew.h>
 
@@ -58,10 +62,11 @@ std::vector<Transaction> loadJournal (AtomicFile& undo)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
-void Journal::initialize (const std::string& location, int size)
+void Journal::initialize (const std::string& location, int size, int coalesce)
 {
   _location = location;
   _size = size;
+  _coalesce = coalesce;
 
   if (! enabled ())
   {
@@ -87,6 +92,140 @@ void Journal::startTransaction ()
   }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Intervals are compared by their serialization, as their ids in the journal
+// are those of the time of recording.
+static std::string intervalKey (const std::string& json)
+{
+  return json.empty () ? "" : IntervalFactory::fromJson (json).serialize ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Whether a transaction only changes intervals that are open, or were closed
+// no earlier than since.
+static bool onlyTracking (const Transaction& transaction, const Datetime& since)
+{
+  auto actions = transaction.getActions ();
+  if (actions.empty ())
+  {
+    return false;
+  }
+
+  for (auto& action : actions)
+  {
+    if (action.getType () != "interval")
+    {
+      return false;
+    }
+
+    for (auto& json : {action.getBefore (), action.getAfter ()})
+    {
+      if (! json.empty ())
+      {
+        Interval interval = IntervalFactory::fromJson (json);
+        if (interval.is_ended () && interval.end < since)
+        {
+          return false;
+        }
+      }
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// One transaction with the actions of first followed by those of second, where
+// an interval added and then changed again is recorded by its final state.
+static Transaction merge (const Transaction& first, const Transaction& second)
+{
+  std::vector <std::pair <std::string, std::string>> changes;
+  for (auto& transaction : {first, second})
+  {
+    for (auto& action : transaction.getActions ())
+    {
+      auto change = changes.end ();
+      if (! action.getBefore ().empty ())
+      {
+        auto key = intervalKey (action.getBefore ());
+        change = std::find_if (changes.begin (), changes.end (),
+                               [&key] (const std::pair <std::string, std::string>& c)
+                               {
+                                 return ! c.second.empty () && intervalKey (c.second) == key;
+                               });
+      }
+
+      if (change == changes.end ())
+      {
+        changes.emplace_back (action.getBefore (), action.getAfter ());
+      }
+      else
+      {
+        change->second = action.getAfter ();
+      }
+    }
+  }
+
+  Transaction merged;
+  for (auto& change : changes)
+  {
+    if (intervalKey (change.first) != intervalKey (change.second))
+    {
+      merged.addUndoAction ("interval", change.first, change.second);
+    }
+  }
+
+  return merged;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Find the last transaction of the journal by reading ever larger parts of its
+// end, rather than all of it. Returns it, if there is one, and its offset.
+static std::vector <Transaction> lastTransaction (AtomicFile& undo, size_t& offset)
+{
+  const std::string marker {"txn:\n"};
+  const size_t size = undo.size ();
+
+  std::string tail;
+  for (size_t length = 4096; ; length *= 4)
+  {
+    auto start = length < size ? size - length : 0;
+    undo.read (tail, start);
+
+    // A marker at the very start of a part may be within a line, unless the
+    // part is the whole journal.
+    auto found = tail.rfind ('\n' + marker);
+    if (found != std::string::npos)
+    {
+      offset = start + found + 1;
+      tail.erase (0, found + 1);
+      break;
+    }
+
+    if (start == 0)
+    {
+      if (tail.compare (0, marker.size (), marker) != 0)
+      {
+        return {};
+      }
+
+      offset = 0;
+      break;
+    }
+  }
+
+  TransactionsFactory transactionsFactory;
+  for (auto& line : split (tail, '\n'))
+  {
+    if (! line.empty ())
+    {
+      transactionsFactory.parseLine (line);
+    }
+  }
+
+  return transactionsFactory.get ();
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 void Journal::endTransaction ()
 {
@@ -102,15 +241,64 @@ void Journal::endTransaction ()
   }
 
   AtomicFile undo (_location);
+  Transaction current = *_currentTransaction;
+  std::vector <Transaction> transactions;
+  bool rewrite = _size > 0;
+  bool merged = false;
+
+  // Tracking changes that follow each other within the coalescing window are
+  // undone together, so they are recorded as one transaction.
+  Datetime since = Clock::now ();
+  since -= _coalesce;
+  bool coalesce = _coalesce > 0 &&
+                  undo.exists () &&
+                  File (_location).mtime () >= since.toEpoch () &&
+                  onlyTracking (current, since);
+
+  // Without a limit on its size, only the end of the journal is read, and only
+  // the last transaction is rewritten when it is merged.
+  if (coalesce && _size < 0)
+  {
+    size_t offset = 0;
+    auto last = lastTransaction (undo, offset);
+    if (last.size () == 1 &&
+        onlyTracking (last.back (), since))
+    {
+      current = merge (last.back (), current);
+
+      // Changes that cancel each other out leave nothing to undo.
+      undo.replace_tail (offset, current.getActions ().empty () ? "" : current.toString ());
+    }
+    else
+    {
+      undo.append (current.toString ());
+    }
+
+    _currentTransaction.reset ();
+    return;
+  }
+
+  if (_size > 1 || coalesce)
+  {
+    transactions = loadJournal (undo);
+  }
 
-  if (_size > 1)
+  if (coalesce &&
+      ! transactions.empty () &&
+      onlyTracking (transactions.back (), since))
   {
-    std::vector <Transaction> transactions = loadJournal (undo);
+    current = merge (transactions.back (), current);
+    transactions.pop_back ();
+    rewrite = true;
+    merged = true;
+  }
 
-    unsigned int toCopy = _size - 1;
+  if (rewrite)
+  {
     auto it = transactions.cbegin ();
     auto end = transactions.cend ();
 
+    unsigned int toCopy = _size > 0 ? _size - 1 : transactions.size ();
     if (transactions.size () > toCopy)
     {
       it += transactions.size () - toCopy;
@@ -122,12 +310,13 @@ void Journal::endTransaction ()
       undo.append (it->toString ());
     }
   }
-  else if (_size == 1)
+
+  // Changes that cancel each other out leave nothing to undo.
+  if (! merged || ! current.getActions ().empty ())
   {
-    undo.truncate ();
+    undo.append (current.toString ());
   }
 
-  undo.append (_currentTransaction->toString ());
   _currentTransaction.reset ();
 }
 
@@ -143,10 +332,17 @@ void Journal::recordIntervalAction (const std::string&  before, const std::strin
   recordUndoAction ("interval", before, after);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+void Journal::recordTagAction (const std::string& before, const std::string& after)
+{
+  recordUndoAction ("tag", before, after);
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Record undoable actions. There are several types:
 //   interval    changes to stored intervals
 //   config      changes to configuration
+//   tag         a tag renamed in all intervals
 //
 // Actions are only recorded if a transaction is open
 //
@@ -164,21 +360,40 @@ void Journal::recordUndoAction (
 ////////////////////////////////////////////////////////////////////////////////
 Transaction Journal::popLastTransaction ()
 {
-  if (! enabled ())
+  auto transactions = popLastTransactions (1);
+
+  if (transactions.empty ())
   {
     return Transaction {};
   }
 
+  return transactions.front ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Remove up to count transactions from the end of the journal, rewriting it
+// once. The last transaction is returned first.
+std::vector <Transaction> Journal::popLastTransactions (int count)
+{
+  if (! enabled () || count < 1)
+  {
+    return {};
+  }
+
   AtomicFile undo (_location);
   std::vector <Transaction> transactions = loadJournal (undo);
 
-  if (transactions.empty ())
+  std::vector <Transaction> popped;
+  while (! transactions.empty () && static_cast <int> (popped.size ()) < count)
   {
-    return Transaction {};
+    popped.push_back (transactions.back ());
+    transactions.pop_back ();
   }
 
-  Transaction last = transactions.back ();
-  transactions.pop_back ();
+  if (popped.empty ())
+  {
+    return {};
+  }
 
   if (transactions.empty ())
   {
@@ -198,5 +413,62 @@ Transaction Journal::popLastTransaction ()
     undo.close ();
   }
 
-  return last;
+  return popped;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Drop the transactions that changed intervals starting before cutoff, and
+// all earlier ones, which could otherwise not be undone in order.
+void Journal::forgetBefore (const Datetime& cutoff)
+{
+  if (! enabled ())
+  {
+    return;
+  }
+
+  AtomicFile undo (_location);
+  if (! undo.exists ())
+  {
+    return;
+  }
+
+  std::vector <Transaction> transactions = loadJournal (undo);
+
+  auto touches = [&cutoff] (const std::string& json)
+  {
+    return ! json.empty () && IntervalFactory::fromJson (json).start < cutoff;
+  };
+
+  auto first = transactions.end ();
+  while (first != transactions.begin ())
+  {
+    auto actions = std::prev (first)->getActions ();
+    if (std::any_of (actions.begin (), actions.end (), [&touches] (const UndoAction& action)
+        {
+          return action.getType () == "interval" &&
+                 (touches (action.getBefore ()) || touches (action.getAfter ()));
+        }))
+    {
+      break;
+    }
+
+    --first;
+  }
+
+  if (first == transactions.begin ())
+  {
+    return;
+  }
+
+  if (first == transactions.end ())
+  {
+    undo.remove ();
+    return;
+  }
+
+  undo.truncate ();
+  for (auto it = first; it != transactions.end (); ++it)
+  {
+    undo.append (it->toString ());
+  }
 }
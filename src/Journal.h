@@ -32,6 +32,7 @@
 #include <string>
 #include <memory>
 #include <Transaction.h>
+#include <Datetime.h>
 
 class Journal
 {
@@ -40,15 +41,18 @@ public:
   Journal(const Journal&) = delete;
   Journal& operator= (const Journal&) = delete;
 
-  void initialize(const std::string&, int);
+  void initialize(const std::string&, int, int coalesce = 0);
 
   void startTransaction ();
   void endTransaction ();
   void recordConfigAction(const std::string&, const std::string&);
   void recordIntervalAction(const std::string&, const std::string&);
+  void recordTagAction (const std::string&, const std::string&);
   bool enabled () const;
 
   Transaction popLastTransaction();
+  void forgetBefore (const Datetime&);
+  std::vector <Transaction> popLastTransactions (int);
 
 private:
   void recordUndoAction (const std::string &, const std::string &, const std::string &);
@@ -56,6 +60,7 @@ private:
   std::string _location {"~/.timewarrior/data/undo.data"};
   std::shared_ptr <Transaction> _currentTransaction = nullptr;
   int _size {0};
+  int _coalesce {0};
 };
 
 #endif
@@ -26,6 +26,7 @@
 
 #include <cmake.h>
 #include <Range.h>
+#include <Clock.h>
 #include <sstream>
 #include <cassert>
 
@@ -58,7 +59,7 @@ bool Range::operator!= (const Range& other) const
 ////////////////////////////////////////////////////////////////////////////////
 void Range::open ()
 {
-  start = Datetime ();
+  start = Clock::now ();
   end = Datetime (0);
 }
 
@@ -72,7 +73,7 @@ void Range::open (const Datetime& value)
 ////////////////////////////////////////////////////////////////////////////////
 void Range::close ()
 {
-  end = Datetime ();
+  end = Clock::now ();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -359,7 +360,7 @@ time_t Range::total () const
   assert (is_open () || end >= start);
 
   if (is_open ())
-    return Datetime () - Datetime (start);
+    return Datetime (Clock::now ()) - Datetime (start);
 
   return Datetime (end) - Datetime (start);
 }
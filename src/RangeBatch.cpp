@@ -0,0 +1,136 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <RangeBatch.h>
+#include <limits>
+
+// An open end compares as later than any time.
+static const int64_t openEnd = std::numeric_limits <int64_t>::max ();
+
+////////////////////////////////////////////////////////////////////////////////
+RangeBatch::RangeBatch (const std::vector <Range>& ranges)
+{
+  _starts.reserve (ranges.size ());
+  _ends.reserve (ranges.size ());
+
+  for (auto& range : ranges)
+    add (range);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RangeBatch::add (const Range& range)
+{
+  _starts.push_back (range.start.toEpoch ());
+  _ends.push_back (range.end.toEpoch ());
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void RangeBatch::clear ()
+{
+  _starts.clear ();
+  _ends.clear ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+unsigned int RangeBatch::size () const
+{
+  return _starts.size ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Range::intersects, which is symmetric:
+//
+//   both started && ((other ends after start && other starts before end) ||
+//                    starts are equal)
+//
+std::vector <unsigned int> RangeBatch::intersecting (const Range& other) const
+{
+  const int64_t otherStart = other.start.toEpoch ();
+  const int64_t otherEnd   = other.is_ended () ? other.end.toEpoch () : openEnd;
+  const auto count = _starts.size ();
+
+  std::vector <uint8_t> mask (count);
+  if (otherStart > 0)
+  {
+    const int64_t* starts = _starts.data ();
+    const int64_t* ends = _ends.data ();
+    uint8_t* out = mask.data ();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      const int64_t end = ends[i] ? ends[i] : openEnd;
+      out[i] = (starts[i] > 0) &
+               (((otherEnd > starts[i]) & (otherStart < end)) |
+                (starts[i] == otherStart));
+    }
+  }
+
+  return select (mask);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Range::encloses with other as the enclosing range, that is the start and the
+// end of a range are each equal to the corresponding end of other or contained
+// in other. Nothing is enclosed by an empty range.
+std::vector <unsigned int> RangeBatch::enclosedBy (const Range& other) const
+{
+  const int64_t otherStart = other.start.toEpoch ();
+  const int64_t otherEnd   = other.end.toEpoch ();
+  const auto count = _starts.size ();
+
+  std::vector <uint8_t> mask (count);
+  if (otherStart != otherEnd)
+  {
+    const int64_t lower = otherStart ? otherStart : std::numeric_limits <int64_t>::min ();
+    const int64_t upper = otherEnd ? otherEnd : openEnd;
+    const int64_t* starts = _starts.data ();
+    const int64_t* ends = _ends.data ();
+    uint8_t* out = mask.data ();
+
+    for (size_t i = 0; i < count; ++i)
+    {
+      out[i] = ((starts[i] == otherStart) | ((lower < starts[i]) & (starts[i] < upper))) &
+               ((ends[i]   == otherEnd)   | ((lower < ends[i])   & (ends[i]   < upper)));
+    }
+  }
+
+  return select (mask);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Turn a mask into a selection vector.
+std::vector <unsigned int> RangeBatch::select (const std::vector <uint8_t>& mask) const
+{
+  std::vector <unsigned int> selection;
+  for (unsigned int i = 0; i < mask.size (); ++i)
+    if (mask[i])
+      selection.push_back (i);
+
+  return selection;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,59 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_RANGEBATCH
+#define INCLUDED_RANGEBATCH
+
+#include <Range.h>
+#include <cstdint>
+#include <vector>
+
+// Many ranges stored as separate arrays of start and end epochs, so that one
+// range can be tested against all of them in a single loop without branches.
+// The tests have the semantics of the Range methods of the same name, and
+// return the indices of the matching ranges in ascending order.
+class RangeBatch
+{
+public:
+  RangeBatch () = default;
+  explicit RangeBatch (const std::vector <Range>&);
+
+  void add (const Range&);
+  void clear ();
+  unsigned int size () const;
+
+  std::vector <unsigned int> intersecting (const Range&) const;
+  std::vector <unsigned int> enclosedBy (const Range&) const;
+
+private:
+  std::vector <unsigned int> select (const std::vector <uint8_t>&) const;
+
+private:
+  std::vector <int64_t> _starts {};
+  std::vector <int64_t> _ends   {};
+};
+
+#endif
@@ -102,6 +102,23 @@ Rules::Rules ()
 
     // Options for the journal / undo file.
     {"journal.size",             "-1"},
+    {"journal.coalesce",         "0"},
+
+    // Append-only log of interval changes, read by 'export since:<seq>'.
+    {"changelog",                "off"},
+
+    // Post-commit hooks, and the most queued commands passed at once.
+    {"hooks",                    "off"},
+    {"hooks.batch",              "100"},
+
+    // Tag hierarchies, such as 'client.project.task'.
+    {"tags.separator",           "."},
+
+    // Options for the annotation index.
+    {"annotations.index",        "off"},
+
+    // Megabytes of data files kept loaded while scanning, 0 for no limit.
+    {"data.memory",              "64"},
   };
 }
 
@@ -0,0 +1,456 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <TagExpression.h>
+#include <Lexer.h>
+#include <format.h>
+#include <timew.h>
+#include <algorithm>
+#include <sstream>
+
+////////////////////////////////////////////////////////////////////////////////
+// Split an expression into words and parentheses. Quoted words are kept with
+// their quotes, so that a tag named 'or' is not mistaken for an operator.
+static std::vector <std::string> tokenizeExpression (const std::string& expression)
+{
+  std::vector <std::string> tokens;
+  std::string token;
+
+  for (std::string::size_type i = 0; i < expression.length (); ++i)
+  {
+    auto c = expression[i];
+
+    if (c == '"' || c == '\'')
+    {
+      auto close = expression.find (c, i + 1);
+      if (close == std::string::npos)
+      {
+        throw format ("Unterminated quote in tag expression '{1}'.", expression);
+      }
+
+      token += expression.substr (i, close - i + 1);
+      i = close;
+    }
+    else if (c == ' ' || c == '(' || c == ')')
+    {
+      if (! token.empty ())
+      {
+        tokens.push_back (token);
+        token.clear ();
+      }
+
+      if (c != ' ')
+      {
+        tokens.push_back (std::string (1, c));
+      }
+    }
+    else
+    {
+      token += c;
+    }
+  }
+
+  if (! token.empty ())
+  {
+    tokens.push_back (token);
+  }
+
+  return tokens;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Grammar:
+//   expr   := and ( 'or' and )*
+//   and    := not ( [ 'and' ] not )*
+//   not    := 'not' not | '(' expr ')' | <tag>
+//
+TagExpression::TagExpression (const std::string& expression)
+{
+  auto tokens = tokenizeExpression (expression);
+  if (tokens.empty ())
+  {
+    return;
+  }
+
+  unsigned int cursor = 0;
+  parseOr (tokens, cursor);
+
+  if (cursor != tokens.size ())
+  {
+    throw format ("Unexpected '{1}' in tag expression '{2}'.", tokens[cursor], expression);
+  }
+
+  checkDepth ();
+  assignBits ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TagExpression::empty () const
+{
+  return _program.empty ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Combine with another expression: this and other.
+void TagExpression::conjoin (const TagExpression& other)
+{
+  if (other.empty ())
+  {
+    return;
+  }
+
+  bool was_empty = empty ();
+  _program.insert (_program.end (), other._program.begin (), other._program.end ());
+
+  if (! was_empty)
+  {
+    _program.push_back (Token {Op::op_and, "", 0});
+  }
+
+  checkDepth ();
+  assignBits ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool TagExpression::matches (const Interval& interval) const
+{
+  if (_program.empty ())
+  {
+    return true;
+  }
+
+  uint64_t bits[maxTags / 64] {};
+  for (auto& tag : interval.tags ())
+  {
+    auto bit = bitOf (tag, 0, tag.length ());
+    if (bit >= 0)
+    {
+      bits[bit / 64] |= uint64_t {1} << (bit % 64);
+    }
+  }
+
+  return evaluate (bits);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Match the serialized form of an interval without parsing it, so that lines
+// which cannot match are not turned into Intervals at all. Each tag is looked
+// up once, in place. A line this cannot read with certainty, such as one with
+// escaped quotes, is reported as matching, and left to ::matches after the
+// full parse.
+bool TagExpression::matchesLine (const std::string& line) const
+{
+  if (_program.empty () ||
+      line.compare (0, 3, "inc") != 0)
+  {
+    return true;
+  }
+
+  uint64_t bits[maxTags / 64] {};
+
+  auto pos = line.find (" #");
+  if (pos != std::string::npos)
+  {
+    pos += 2;
+    while (pos < line.length ())
+    {
+      if (line[pos] == ' ')
+      {
+        ++pos;
+        continue;
+      }
+
+      std::string::size_type begin = pos;
+      std::string::size_type end;
+
+      if (line[pos] == '"')
+      {
+        begin = pos + 1;
+        end = line.find ('"', begin);
+        if (end == std::string::npos ||
+            line.find ('\\', begin) < end)
+        {
+          return true;
+        }
+
+        pos = end + 1;
+      }
+      else
+      {
+        end = line.find (' ', pos);
+        if (end == std::string::npos)
+        {
+          end = line.length ();
+        }
+
+        // The annotation follows.
+        if (end - pos == 1 && line[pos] == '#')
+        {
+          break;
+        }
+
+        // Numbers, quotes and non-ASCII characters are left to the Lexer.
+        if (Lexer::isDigit (line[pos]) || line[pos] == '.')
+        {
+          return true;
+        }
+
+        for (auto i = pos; i < end; ++i)
+        {
+          auto c = static_cast <unsigned char> (line[i]);
+          if (c >= 0x80 || c == '\'' || c == '"' || c == '\\')
+          {
+            return true;
+          }
+        }
+
+        pos = end;
+      }
+
+      auto bit = bitOf (line, begin, end - begin);
+      if (bit >= 0)
+      {
+        bits[bit / 64] |= uint64_t {1} << (bit % 64);
+      }
+    }
+  }
+
+  return evaluate (bits);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+std::string TagExpression::dump () const
+{
+  std::stringstream out;
+  out << "TagExpression";
+
+  for (auto& token : _program)
+  {
+    switch (token.op)
+    {
+    case Op::tag:    out << ' ' << quoteIfNeeded (token.name); break;
+    case Op::op_and: out << " and"; break;
+    case Op::op_or:  out << " or";  break;
+    case Op::op_not: out << " not"; break;
+    }
+  }
+
+  return out.str ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Give every distinct tag in the program a bit. The bits are kept sorted by
+// tag name, so a tag is found without building a string for it.
+void TagExpression::assignBits ()
+{
+  _tagBits.clear ();
+  for (auto& token : _program)
+  {
+    if (token.op == Op::tag)
+    {
+      _tagBits.emplace_back (token.name, 0);
+    }
+  }
+
+  std::sort (_tagBits.begin (), _tagBits.end ());
+  _tagBits.erase (std::unique (_tagBits.begin (), _tagBits.end ()), _tagBits.end ());
+
+  if (_tagBits.size () > maxTags)
+  {
+    throw std::string ("Tag expression refers to too many tags.");
+  }
+
+  for (unsigned int i = 0; i < _tagBits.size (); ++i)
+  {
+    _tagBits[i].second = i;
+  }
+
+  for (auto& token : _program)
+  {
+    if (token.op == Op::tag)
+    {
+      token.bit = bitOf (token.name, 0, token.name.length ());
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The bit of the tag text.substr (pos, length), or -1 if the expression does
+// not refer to it.
+int TagExpression::bitOf (
+  const std::string& text,
+  std::string::size_type pos,
+  std::string::size_type length) const
+{
+  std::size_t low = 0;
+  std::size_t high = _tagBits.size ();
+
+  while (low < high)
+  {
+    auto middle = low + (high - low) / 2;
+    auto order = text.compare (pos, length, _tagBits[middle].first);
+
+    if (order == 0)
+    {
+      return static_cast <int> (_tagBits[middle].second);
+    }
+
+    if (order > 0)
+    {
+      low = middle + 1;
+    }
+    else
+    {
+      high = middle;
+    }
+  }
+
+  return -1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Evaluate the postfix program against a bitset of present tags, using one
+// word as the operand stack.
+bool TagExpression::evaluate (const uint64_t* bits) const
+{
+  uint64_t stack = 0;
+  for (auto& token : _program)
+  {
+    switch (token.op)
+    {
+    case Op::tag:
+      stack = (stack << 1) | ((bits[token.bit / 64] >> (token.bit % 64)) & 1);
+      break;
+
+    case Op::op_not:
+      stack ^= 1;
+      break;
+
+    case Op::op_and:
+      stack = (stack >> 1) & (stack | ~uint64_t {1});
+      break;
+
+    case Op::op_or:
+      stack = (stack >> 1) | (stack & 1);
+      break;
+    }
+  }
+
+  return stack & 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The evaluation stack in ::evaluate is a single machine word.
+void TagExpression::checkDepth () const
+{
+  unsigned int depth = 0;
+  for (auto& token : _program)
+  {
+    if (token.op == Op::tag)
+    {
+      if (++depth > 64)
+      {
+        throw std::string ("Tag expression is too complex.");
+      }
+    }
+    else if (token.op != Op::op_not)
+    {
+      --depth;
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TagExpression::parseOr (const std::vector <std::string>& tokens, unsigned int& cursor)
+{
+  parseAnd (tokens, cursor);
+
+  while (cursor < tokens.size () && tokens[cursor] == "or")
+  {
+    ++cursor;
+    parseAnd (tokens, cursor);
+    _program.push_back (Token {Op::op_or, "", 0});
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TagExpression::parseAnd (const std::vector <std::string>& tokens, unsigned int& cursor)
+{
+  parseNot (tokens, cursor);
+
+  while (cursor < tokens.size () &&
+         tokens[cursor] != "or"  &&
+         tokens[cursor] != ")")
+  {
+    // The 'and' is optional, juxtaposition means the same.
+    if (tokens[cursor] == "and")
+    {
+      ++cursor;
+    }
+
+    parseNot (tokens, cursor);
+    _program.push_back (Token {Op::op_and, "", 0});
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void TagExpression::parseNot (const std::vector <std::string>& tokens, unsigned int& cursor)
+{
+  if (cursor >= tokens.size ())
+  {
+    throw std::string ("Tag expression is incomplete.");
+  }
+
+  auto& token = tokens[cursor++];
+
+  if (token == "not")
+  {
+    parseNot (tokens, cursor);
+    _program.push_back (Token {Op::op_not, "", 0});
+  }
+  else if (token == "(")
+  {
+    parseOr (tokens, cursor);
+
+    if (cursor >= tokens.size () || tokens[cursor] != ")")
+    {
+      throw std::string ("Missing ')' in tag expression.");
+    }
+
+    ++cursor;
+  }
+  else if (token == ")" || token == "and" || token == "or")
+  {
+    throw format ("Unexpected '{1}' in tag expression.", token);
+  }
+  else
+  {
+    _program.push_back (Token {Op::tag, Lexer::dequote (token), 0});
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
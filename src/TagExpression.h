@@ -0,0 +1,82 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_TAGEXPRESSION
+#define INCLUDED_TAGEXPRESSION
+
+#include <Interval.h>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// A boolean expression over tags, such as:
+//
+//   (CLIENT_A or CLIENT_B) and not INTERNAL
+//
+// The expression is parsed into postfix form, and every referenced tag is
+// given a bit, so that matching an interval only needs a small bitset of its
+// tags.
+class TagExpression
+{
+public:
+  TagExpression () = default;
+  explicit TagExpression (const std::string&);
+
+  bool empty () const;
+  void conjoin (const TagExpression&);
+
+  bool matches (const Interval&) const;
+  bool matchesLine (const std::string&) const;
+
+  std::string dump () const;
+
+private:
+  enum class Op { tag, op_and, op_or, op_not };
+
+  struct Token
+  {
+    Op           op;
+    std::string  name;
+    unsigned int bit;
+  };
+
+  static const unsigned int maxTags = 256;
+
+  void assignBits ();
+  int bitOf (const std::string&, std::string::size_type, std::string::size_type) const;
+  bool evaluate (const uint64_t*) const;
+  void checkDepth () const;
+  void parseOr (const std::vector <std::string>&, unsigned int&);
+  void parseAnd (const std::vector <std::string>&, unsigned int&);
+  void parseNot (const std::vector <std::string>&, unsigned int&);
+
+private:
+  std::vector <Token>     _program  {};
+  std::vector <std::pair <std::string, unsigned int>> _tagBits {};
+};
+
+#endif
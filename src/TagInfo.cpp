@@ -51,6 +51,12 @@ bool TagInfo::hasCount ()
   return _count > 0;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+unsigned int TagInfo::count () const
+{
+  return _count;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 std::string TagInfo::toJson ()
 {
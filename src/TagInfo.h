@@ -38,6 +38,7 @@ public:
   unsigned int decrement ();
 
   bool hasCount ();
+  unsigned int count () const;
 
   std::string toJson ();
 
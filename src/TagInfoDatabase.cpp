@@ -69,6 +69,39 @@ int TagInfoDatabase::decrementTag (const std::string& tag)
   return search->second.decrement ();
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Return the tag count, 0 if it does not exist
+//
+unsigned int TagInfoDatabase::count (const std::string& tag) const
+{
+  auto search = _tagInformation.find (tag);
+
+  if (search == _tagInformation.end ())
+  {
+    return 0;
+  }
+
+  return search->second.count ();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Set tag count
+// If it does not exist, a new entry is created
+//
+void TagInfoDatabase::setCount (const std::string& tag, unsigned int count)
+{
+  auto search = _tagInformation.find (tag);
+
+  if (search == _tagInformation.end ())
+  {
+    add (tag, TagInfo {count});
+    return;
+  }
+
+  _is_modified = true;
+  search->second = TagInfo {count};
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Add tag to database
 //
@@ -76,6 +109,7 @@ void TagInfoDatabase::add (const std::string& tag, const TagInfo& tagInfo)
 {
   _is_modified = true;
   _tagInformation.emplace (tag, tagInfo);
+  link (tag);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -93,6 +127,97 @@ std::set <std::string> TagInfoDatabase::tags () const
   return tags;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// Set the separator of tag hierarchies, such as '.' in 'client.project.task'
+//
+// An empty separator disables hierarchies. The relations of all known tags are
+// derived again.
+//
+void TagInfoDatabase::setSeparator (const std::string& separator)
+{
+  _separator = separator;
+  _ancestors.clear ();
+  _children.clear ();
+
+  for (auto& item : _tagInformation)
+  {
+    link (item.first);
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Return the ancestors of a tag, outermost first
+//
+// For 'client.project.task' these are 'client' and 'client.project'. The
+// ancestors need not be tags themselves.
+//
+const std::vector <std::string>& TagInfoDatabase::ancestors (const std::string& tag) const
+{
+  static const std::vector <std::string> none {};
+
+  auto search = _ancestors.find (tag);
+
+  if (search == _ancestors.end ())
+  {
+    return none;
+  }
+
+  return search->second;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Return the direct children of a tag or of an ancestor of a tag
+//
+std::set <std::string> TagInfoDatabase::children (const std::string& tag) const
+{
+  auto search = _children.find (tag);
+
+  if (search == _children.end ())
+  {
+    return {};
+  }
+
+  return search->second;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Record the ancestry of a tag, and of each of its ancestors
+//
+void TagInfoDatabase::link (const std::string& tag)
+{
+  if (_separator.empty () || _ancestors.count (tag))
+  {
+    return;
+  }
+
+  std::vector <std::string> path;
+  auto end = tag.find (_separator);
+
+  while (end != std::string::npos)
+  {
+    if (end > 0)
+    {
+      auto prefix = tag.substr (0, end);
+      if (! path.empty ())
+      {
+        _children[path.back ()].insert (prefix);
+      }
+
+      _ancestors.emplace (prefix, path);
+      path.push_back (prefix);
+    }
+
+    end = tag.find (_separator, end + _separator.length ());
+  }
+
+  if (! path.empty ())
+  {
+    _children[path.back ()].insert (tag);
+  }
+
+  _ancestors.emplace (tag, path);
+}
+
 bool TagInfoDatabase::is_modified () const
 {
   return _is_modified;
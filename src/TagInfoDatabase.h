@@ -30,6 +30,7 @@
 #include <set>
 #include <string>
 #include <map>
+#include <vector>
 #include <TagInfo.h>
 
 class TagInfoDatabase
@@ -37,19 +38,31 @@ class TagInfoDatabase
 public:
   int incrementTag (const std::string&);
   int decrementTag (const std::string&);
+  unsigned int count (const std::string&) const;
+  void setCount (const std::string&, unsigned int);
 
   void add (const std::string&, const TagInfo&);
 
   std::set <std::string> tags () const;
 
+  void setSeparator (const std::string&);
+  const std::vector <std::string>& ancestors (const std::string&) const;
+  std::set <std::string> children (const std::string&) const;
+
   std::string toJson ();
 
   bool is_modified () const;
   void clear_modified ();
 
 private:
+  void link (const std::string&);
+
   std::map <std::string, TagInfo> _tagInformation {};
   bool _is_modified {false};
+
+  std::string _separator {};
+  std::map <std::string, std::vector <std::string>> _ancestors {};
+  std::map <std::string, std::set <std::string>> _children {};
 };
 
 #endif
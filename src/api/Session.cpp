@@ -0,0 +1,390 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <api/Session.h>
+#include <AnnotationIndex.h>
+#include <AtomicFile.h>
+#include <CLI.h>
+#include <Clock.h>
+#include <Database.h>
+#include <IntervalFactory.h>
+#include <Journal.h>
+#include <Rules.h>
+#include <FS.h>
+#include <format.h>
+#include <timew.h>
+#include <algorithm>
+
+namespace timew
+{
+
+////////////////////////////////////////////////////////////////////////////////
+Error::Error (const std::string& message)
+: std::runtime_error (message)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+struct Session::Implementation
+{
+  // The files changed and not yet committed. They go first, so that the
+  // database is gone before their temporary files are removed.
+  AtomicFile::Changes changes {};
+
+  // The time of the current call.
+  Clock    clock    {};
+
+  Rules    rules    {};
+  Journal  journal  {};
+  Database database {};
+
+  // Without arguments, there are no hints such as :adjust or :fill.
+  CLI      cli      {};
+
+  bool     open          {false};
+  bool     inTransaction {false};
+
+  void requireOpen () const;
+  void refresh ();
+  void change ();
+
+  template <typename F>
+  auto run (F function) -> decltype (function ());
+};
+
+////////////////////////////////////////////////////////////////////////////////
+void Session::Implementation::requireOpen () const
+{
+  if (! open)
+  {
+    throw std::string ("No database is open.");
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Other processes, or other Sessions, may have changed the database since the
+// last call. Their changes are seen unless this Session has its own pending.
+void Session::Implementation::refresh ()
+{
+  requireOpen ();
+
+  if (! inTransaction)
+  {
+    database.refresh ();
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// All changes up to the next commit are recorded as one transaction.
+void Session::Implementation::change ()
+{
+  requireOpen ();
+
+  if (! inTransaction)
+  {
+    journal.startTransaction ();
+    inTransaction = true;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The internals report errors as strings, which the API turns into Error.
+// Each call is one run, with its own 'now' on the clock of the session, and
+// changes kept apart from those of other Sessions.
+template <typename F>
+auto Session::Implementation::run (F function) -> decltype (function ())
+{
+  clock.release ();
+  Clock::Scope clockScope (clock);
+  AtomicFile::Scope changesScope (changes);
+
+  try
+  {
+    return function ();
+  }
+
+  catch (const std::string& error)
+  {
+    throw Error (error);
+  }
+
+  catch (const char* error)
+  {
+    throw Error (error);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static IntervalView view (const Interval& interval)
+{
+  Interval copy {interval};
+  return IntervalView {interval.id,
+                       interval.start.toEpoch (),
+                       interval.end.toEpoch (),
+                       std::vector <std::string> (interval.tags ().begin (), interval.tags ().end ()),
+                       copy.getAnnotation ()};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+Session::Session ()
+: _impl (new Implementation)
+{
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Uncommitted changes are discarded.
+Session::~Session () = default;
+
+////////////////////////////////////////////////////////////////////////////////
+// Open the database at location, the equivalent of $TIMEWARRIORDB. The
+// location is created if it does not exist and create is true.
+void Session::open (const std::string& location, bool create)
+{
+  // Reopening discards the uncommitted changes.
+  _impl.reset (new Implementation);
+  _impl->run ([&] ()
+  {
+    auto& rules = _impl->rules;
+
+    Directory dbLocation (location);
+    if (! dbLocation.exists ())
+    {
+      if (! create)
+        throw format ("There is no database at '{1}'", dbLocation._data);
+
+      dbLocation.create (0700);
+    }
+
+    if (! dbLocation.readable () ||
+        ! dbLocation.writable () ||
+        ! dbLocation.executable ())
+    {
+      throw format ("Database is not readable at '{1}'", dbLocation._data);
+    }
+
+    Directory data (dbLocation);
+    data += "data";
+    if (! data.exists ())
+      data.create (0700);
+
+    Path configFile (dbLocation);
+    configFile += "timewarrior.cfg";
+    if (configFile.exists ())
+      rules.load (configFile._data);
+
+    // Never produce output, nor ask.
+    rules.set ("verbose",      "off");
+    rules.set ("confirmation", "off");
+    rules.set ("color",        "off");
+    rules.set ("temp.db",      dbLocation._data);
+
+    _impl->journal.initialize (data._data + "/undo.data",
+                               rules.getInteger ("journal.size"),
+                               rules.getInteger ("journal.coalesce"));
+    _impl->database.initialize (data._data, _impl->journal, false);
+    _impl->database.setTagSeparator (rules.get ("tags.separator"));
+    _impl->database.setMemoryBudget (static_cast <size_t> (std::max (rules.getInteger ("data.memory"), 0)) * 1024 * 1024);
+
+    if (rules.getBoolean ("annotations.index"))
+      _impl->database.enableAnnotationIndex ();
+
+    if (rules.getBoolean ("changelog"))
+      _impl->database.enableChangeLog ();
+
+    if (rules.getBoolean ("hooks"))
+      _impl->database.enableHooks (dbLocation._data, static_cast <unsigned int> (std::max (rules.getInteger ("hooks.batch"), 1)));
+
+    _impl->open = true;
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Session::isOpen () const
+{
+  return _impl->open;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Intervals matching the query, sorted by start time, as 'export' returns them.
+std::vector <IntervalView> Session::query (const Query& query)
+{
+  return _impl->run ([&] ()
+  {
+    _impl->refresh ();
+
+    Interval filter;
+    if (query.start)
+      filter.start = Datetime (query.start);
+
+    if (query.end)
+      filter.end = Datetime (query.end);
+
+    for (auto& tag : query.tags)
+      filter.tag (tag);
+
+    std::vector <std::string> words;
+    for (auto& word : query.words)
+      for (auto& token : AnnotationIndex::tokenize (word))
+        words.push_back (token);
+
+    std::vector <IntervalView> views;
+    for (auto& interval : getTracked (_impl->database, _impl->rules, filter, TagExpression (query.expression), words))
+      views.push_back (view (interval));
+
+    return views;
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The open interval, or, if there is none, an interval with id 0.
+IntervalView Session::active ()
+{
+  return _impl->run ([&] ()
+  {
+    _impl->refresh ();
+
+    auto latest = getLatestInterval (_impl->database);
+    if (! latest.is_open ())
+      return IntervalView {0, 0, 0, {}, ""};
+
+    return view (latest);
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Start tracking the tags, now or at the given time, as 'start' does.
+void Session::start (const std::vector <std::string>& tags, time_t when)
+{
+  _impl->run ([&] ()
+  {
+    _impl->refresh ();
+
+    Interval interval;
+    interval.start = when ? Datetime (when) : Clock::now ();
+    for (auto& tag : tags)
+      interval.tag (tag);
+
+    _impl->change ();
+    startTracking (_impl->cli, _impl->rules, _impl->database, interval, false);
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Stop the open interval, now or at the given time, as 'stop' does.
+void Session::stop (time_t when)
+{
+  _impl->run ([&] ()
+  {
+    _impl->refresh ();
+
+    auto& rules = _impl->rules;
+    auto& database = _impl->database;
+
+    auto latest = getLatestInterval (database);
+    if (! latest.is_open ())
+      throw std::string ("There is no active time tracking.");
+
+    Datetime end = when ? Datetime (when) : Clock::now ();
+    if (end <= latest.start)
+      throw std::string ("The end of a date range must be after the start.");
+
+    _impl->change ();
+
+    Interval modified {latest};
+    modified.end = end;
+
+    database.deleteInterval (latest);
+    validate (_impl->cli, rules, database, modified);
+
+    for (auto& interval : flatten (modified, getAllExclusions (rules, modified)))
+      database.addInterval (interval, false);
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Record a closed interval, as 'track' does, split around exclusions.
+void Session::track (
+  time_t start,
+  time_t end,
+  const std::vector <std::string>& tags,
+  const std::string& annotation)
+{
+  _impl->run ([&] ()
+  {
+    _impl->refresh ();
+
+    auto& rules = _impl->rules;
+    auto& database = _impl->database;
+
+    if (! start || end <= start)
+      throw std::string ("The end of a date range must be after the start.");
+
+    Interval filter;
+    filter.start = Datetime (start);
+    filter.end = Datetime (end);
+    filter.setAnnotation (annotation);
+    for (auto& tag : tags)
+      filter.tag (tag);
+
+    _impl->change ();
+
+    // Validation must occur before flattening.
+    validate (_impl->cli, rules, database, filter);
+
+    for (auto& interval : flatten (filter, getAllExclusions (rules, filter)))
+      database.addInterval (interval, false);
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+bool Session::modified () const
+{
+  return _impl->inTransaction;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Write all changes, and record them as one undo step.
+void Session::commit ()
+{
+  _impl->run ([&] ()
+  {
+    _impl->refresh ();
+
+    if (_impl->inTransaction)
+    {
+      _impl->journal.endTransaction ();
+      _impl->inTransaction = false;
+    }
+
+    _impl->database.commit ();
+    _impl->database.publish ();
+  });
+}
+
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_TIMEW_SESSION
+#define INCLUDED_TIMEW_SESSION
+
+#include <ctime>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Only what is marked TIMEW_API is exported from the shared library.
+#ifndef TIMEW_API
+#if defined (__GNUC__)
+#define TIMEW_API __attribute__ ((visibility ("default")))
+#else
+#define TIMEW_API
+#endif
+#endif
+
+// The embeddable Timewarrior API.
+//
+// A Session opens a database directory, such as ~/.timewarrior, and applies
+// its configuration. Queries and changes behave as the export, start, stop and
+// track commands do, but nothing is written to stdout or stderr, and no
+// questions are asked. Changes are kept in memory until commit (), and all the
+// changes of one commit are a single undo step.
+//
+// Each Session keeps its own changes until commit (), and sees those other
+// Sessions or processes committed before each call, unless it has changes of
+// its own pending. Committing fails if a file it changes was changed by
+// someone else meanwhile. A Session is not thread safe, but several may be
+// used, each by one thread.
+namespace timew
+{
+
+// Every failure is reported as an Error, with the message the command line
+// would show.
+class TIMEW_API Error : public std::runtime_error
+{
+public:
+  explicit Error (const std::string&);
+};
+
+// A tracked interval. Times are seconds since the epoch, and end is 0 while
+// the interval is open. Ids are those of the command line: @1 is the latest.
+struct IntervalView
+{
+  int                       id;
+  time_t                    start;
+  time_t                    end;
+  std::vector <std::string> tags;
+  std::string               annotation;
+};
+
+// Intervals overlapping [start, end) that have all the tags, satisfy the tag
+// expression and whose annotation contains all the words. A 0 start or end
+// leaves that side of the range unbounded.
+struct Query
+{
+  time_t                    start      {0};
+  time_t                    end        {0};
+  std::vector <std::string> tags       {};
+  std::string               expression {};
+  std::vector <std::string> words      {};
+};
+
+class TIMEW_API Session
+{
+public:
+  Session ();
+  ~Session ();
+  Session (const Session&) = delete;
+  Session& operator= (const Session&) = delete;
+
+  void open (const std::string&, bool create = false);
+  bool isOpen () const;
+
+  std::vector <IntervalView> query (const Query& = Query ());
+  IntervalView active ();
+
+  void start (const std::vector <std::string>&, time_t = 0);
+  void stop (time_t = 0);
+  void track (time_t, time_t, const std::vector <std::string>&, const std::string& = "");
+
+  bool modified () const;
+  void commit ();
+
+private:
+  struct Implementation;
+  std::unique_ptr <Implementation> _impl;
+};
+
+}
+
+#endif
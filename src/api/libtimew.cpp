@@ -0,0 +1,258 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <api/libtimew.h>
+#include <api/Session.h>
+#include <new>
+
+////////////////////////////////////////////////////////////////////////////////
+struct timew_session
+{
+  timew::Session session {};
+  std::string    error   {};
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// The views own the strings, the pointer arrays refer to them.
+struct timew_intervals
+{
+  std::vector <timew::IntervalView>         views    {};
+  std::vector <std::vector <const char*>>   tags     {};
+  size_t                                    position {0};
+
+  void add (timew::IntervalView&&);
+};
+
+////////////////////////////////////////////////////////////////////////////////
+void timew_intervals::add (timew::IntervalView&& view)
+{
+  views.push_back (std::move (view));
+  tags.emplace_back ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// No exception may cross the C interface.
+template <typename F>
+static timew_status call (timew_session* handle, F function)
+{
+  if (! handle)
+    return TIMEW_INVALID;
+
+  try
+  {
+    function (handle->session);
+    handle->error.clear ();
+    return TIMEW_OK;
+  }
+
+  catch (const std::bad_alloc&)
+  {
+    return TIMEW_NOMEMORY;
+  }
+
+  catch (const std::exception& error)
+  {
+    handle->error = error.what ();
+  }
+
+  catch (...)
+  {
+    handle->error = "Unknown error.";
+  }
+
+  return TIMEW_ERROR;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static std::vector <std::string> strings (const char* const* array, size_t count)
+{
+  std::vector <std::string> result;
+  for (size_t i = 0; array && i < count; ++i)
+    if (array[i])
+      result.emplace_back (array[i]);
+
+  return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The pointers are set once the views no longer move.
+static timew_intervals* finish (timew_intervals* intervals)
+{
+  for (size_t i = 0; i < intervals->views.size (); ++i)
+  {
+    for (auto& tag : intervals->views[i].tags)
+      intervals->tags[i].push_back (tag.c_str ());
+  }
+
+  return intervals;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int timew_abi_version (void)
+{
+  return TIMEW_ABI_VERSION;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+timew_status timew_open (const char* location, int create, timew_session** session)
+{
+  if (! location || ! session)
+    return TIMEW_INVALID;
+
+  *session = new (std::nothrow) timew_session;
+  if (! *session)
+    return TIMEW_NOMEMORY;
+
+  return call (*session, [&] (timew::Session& s) { s.open (location, create != 0); });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Uncommitted changes are discarded.
+void timew_close (timew_session* session)
+{
+  delete session;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+const char* timew_last_error (const timew_session* session)
+{
+  return session ? session->error.c_str () : "";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+timew_status timew_query (timew_session* session, const timew_query_t* query, timew_intervals** intervals)
+{
+  if (! intervals)
+    return TIMEW_INVALID;
+
+  *intervals = nullptr;
+  return call (session, [&] (timew::Session& s)
+  {
+    timew::Query q;
+    if (query)
+    {
+      q.start = query->start;
+      q.end   = query->end;
+      q.tags  = strings (query->tags, query->tag_count);
+      if (query->expression)
+        q.expression = query->expression;
+    }
+
+    std::unique_ptr <timew_intervals> result (new timew_intervals);
+    for (auto& view : s.query (q))
+      result->add (std::move (view));
+
+    *intervals = finish (result.release ());
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Yields the open interval, if there is one.
+timew_status timew_active (timew_session* session, timew_intervals** intervals)
+{
+  if (! intervals)
+    return TIMEW_INVALID;
+
+  *intervals = nullptr;
+  return call (session, [&] (timew::Session& s)
+  {
+    std::unique_ptr <timew_intervals> result (new timew_intervals);
+    auto view = s.active ();
+    if (view.id)
+      result->add (std::move (view));
+
+    *intervals = finish (result.release ());
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+size_t timew_count (const timew_intervals* intervals)
+{
+  return intervals ? intervals->views.size () : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+timew_status timew_next (timew_intervals* intervals, timew_interval* interval)
+{
+  if (! intervals || ! interval)
+    return TIMEW_INVALID;
+
+  if (intervals->position >= intervals->views.size ())
+    return TIMEW_END;
+
+  auto i = intervals->position++;
+  auto& view = intervals->views[i];
+
+  interval->id         = view.id;
+  interval->start      = view.start;
+  interval->end        = view.end;
+  interval->tags       = intervals->tags[i].data ();
+  interval->tag_count  = intervals->tags[i].size ();
+  interval->annotation = view.annotation.c_str ();
+  return TIMEW_OK;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+void timew_release (timew_intervals* intervals)
+{
+  delete intervals;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+timew_status timew_start (timew_session* session, int64_t when, const char* const* tags, size_t tag_count)
+{
+  return call (session, [&] (timew::Session& s) { s.start (strings (tags, tag_count), when); });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+timew_status timew_stop (timew_session* session, int64_t when)
+{
+  return call (session, [&] (timew::Session& s) { s.stop (when); });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+timew_status timew_track (
+  timew_session* session,
+  int64_t start,
+  int64_t end,
+  const char* const* tags,
+  size_t tag_count,
+  const char* annotation)
+{
+  return call (session, [&] (timew::Session& s)
+  {
+    s.track (start, end, strings (tags, tag_count), annotation ? annotation : "");
+  });
+}
+
+////////////////////////////////////////////////////////////////////////////////
+timew_status timew_commit (timew_session* session)
+{
+  return call (session, [&] (timew::Session& s) { s.commit (); });
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef INCLUDED_TIMEW_LIBTIMEW
+#define INCLUDED_TIMEW_LIBTIMEW
+
+#include <stddef.h>
+#include <stdint.h>
+
+// The C interface of libtimew, for use from other languages.
+//
+// All objects are opaque handles, created and released by the library. Times
+// are seconds since the epoch. Every function that can fail returns a status,
+// and the message for the last failure of a session is available from
+// timew_last_error ().
+//
+// Each session keeps its own changes until timew_commit, and fails to commit
+// them if another session or process changed the same data meanwhile.
+//
+// Strings returned by the library, such as tags and annotations, are owned by
+// the handle they came from, and remain valid until that handle is released.
+// They are not copied.
+//
+// The layout of the structures below only changes with TIMEW_ABI_VERSION.
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TIMEW_ABI_VERSION 1
+
+// Only what is marked TIMEW_API is exported from the shared library.
+#ifndef TIMEW_API
+#if defined (__GNUC__)
+#define TIMEW_API __attribute__ ((visibility ("default")))
+#else
+#define TIMEW_API
+#endif
+#endif
+
+typedef enum
+{
+  TIMEW_OK       = 0,   // Success.
+  TIMEW_END      = 1,   // An iterator has no more intervals.
+  TIMEW_ERROR    = 2,   // The operation failed, see timew_last_error ().
+  TIMEW_INVALID  = 3,   // A required argument was null.
+  TIMEW_NOMEMORY = 4    // Allocation failed.
+} timew_status;
+
+typedef struct timew_session   timew_session;
+typedef struct timew_intervals timew_intervals;
+
+// A tracked interval. The end is 0 while the interval is open.
+typedef struct
+{
+  int                id;
+  int64_t            start;
+  int64_t            end;
+  const char* const* tags;
+  size_t             tag_count;
+  const char*        annotation;
+} timew_interval;
+
+// Intervals overlapping [start, end) that have all the tags, and satisfy the
+// tag expression. A 0 start or end leaves that side of the range unbounded,
+// and null tags or expression do not restrict the result.
+typedef struct
+{
+  int64_t            start;
+  int64_t            end;
+  const char* const* tags;
+  size_t             tag_count;
+  const char*        expression;
+} timew_query_t;
+
+TIMEW_API int          timew_abi_version  (void);
+
+// A session is returned even if opening fails, so that the error can be read,
+// and must always be closed.
+
+TIMEW_API timew_status timew_open         (const char* location, int create, timew_session** session);
+TIMEW_API void         timew_close        (timew_session* session);
+TIMEW_API const char*  timew_last_error   (const timew_session* session);
+
+TIMEW_API timew_status timew_query        (timew_session* session, const timew_query_t* query, timew_intervals** intervals);
+TIMEW_API timew_status timew_active       (timew_session* session, timew_intervals** intervals);
+TIMEW_API size_t       timew_count        (const timew_intervals* intervals);
+TIMEW_API timew_status timew_next         (timew_intervals* intervals, timew_interval* interval);
+TIMEW_API void         timew_release      (timew_intervals* intervals);
+
+TIMEW_API timew_status timew_start        (timew_session* session, int64_t when, const char* const* tags, size_t tag_count);
+TIMEW_API timew_status timew_stop         (timew_session* session, int64_t when);
+TIMEW_API timew_status timew_track        (timew_session* session, int64_t start, int64_t end, const char* const* tags, size_t tag_count, const char* annotation);
+TIMEW_API timew_status timew_commit       (timew_session* session);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
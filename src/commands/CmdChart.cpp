@@ -27,6 +27,7 @@
 #include <Duration.h>
 #include <Range.h>
 #include <Chart.h>
+#include <Clock.h>
 #include <ChartConfig.h>
 #include <commands.h>
 #include <timew.h>
@@ -94,8 +95,9 @@ int renderChart (
 {
   const bool verbose = rules.getBoolean ("verbose");
 
-  // Load the data.
-  const auto tracked = getTracked (database, rules, filter);
+  // Load the data, all of one generation.
+  database.snapshot ();
+  const auto tracked = getAllTracked (database, rules, filter, cli.getTagExpression (), cli.getAnnotationWords ());
 
   if (tracked.empty ())
   {
@@ -139,7 +141,7 @@ int renderChart (
     throw format ("Invalid value for 'reports.{1}.lines': '{2}'", type, num_lines);
 
   ChartConfig configuration {};
-  configuration.reference_datetime = Datetime ();
+  configuration.reference_datetime = Clock::now ();
   configuration.with_label_month = rules.getBoolean ("reports." + type + ".month");
   configuration.with_label_week = rules.getBoolean ("reports." + type + ".week");
   configuration.with_label_weekday = rules.getBoolean ("reports." + type + ".weekday");
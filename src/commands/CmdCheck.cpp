@@ -0,0 +1,62 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <commands.h>
+#include <timew.h>
+#include <iostream>
+
+////////////////////////////////////////////////////////////////////////////////
+// Support:
+//   timew check
+//
+// Verifies every data file against the checksum recorded when it was last
+// written, and reports the lines of changed files that are not intervals.
+int CmdCheck (
+  Rules& rules,
+  Database& database)
+{
+  const bool verbose = rules.getBoolean ("verbose");
+
+  unsigned int files;
+  unsigned int edited;
+  auto problems = database.check (files, edited);
+
+  if (verbose)
+  {
+    std::cout << "Checked " << files << (files == 1 ? " data file" : " data files")
+              << ", " << edited << " edited outside of Timewarrior.\n";
+  }
+
+  for (auto& problem : problems)
+  {
+    std::cout << problem << '\n';
+  }
+
+  return problems.empty () ? 0 : 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,125 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <format.h>
+#include <commands.h>
+#include <timew.h>
+#include <algorithm>
+#include <iostream>
+
+////////////////////////////////////////////////////////////////////////////////
+// Support:
+//   timew compact [<range>] [:exclusions]
+//
+// Merges touching intervals with the same tags and annotation. With the
+// ':exclusions' hint, intervals are kept apart where an exclusion starts or
+// ends, as when they were split around it.
+int CmdCompact (
+  const CLI& cli,
+  Rules& rules,
+  Database& database,
+  Journal& journal)
+{
+  const bool verbose = rules.getBoolean ("verbose");
+
+  auto filter = cli.getFilter ();
+  std::vector <Interval> tracked;
+  for (auto& interval : getTracked (database, rules, filter))
+  {
+    // The open interval is left as it is.
+    if (! interval.is_open () && ! interval.synthetic)
+    {
+      tracked.push_back (interval);
+    }
+  }
+
+  std::sort (tracked.begin (), tracked.end (), [] (const Interval& a, const Interval& b)
+  {
+    return a.start < b.start;
+  });
+
+  std::set <Datetime> boundaries;
+  if (findHint (cli, ":exclusions") && ! tracked.empty ())
+  {
+    for (auto& exclusion : getAllExclusions (rules, {tracked.front ().start, tracked.back ().end}))
+    {
+      boundaries.insert (exclusion.start);
+      boundaries.insert (exclusion.end);
+    }
+  }
+
+  // One sorted pass, extending the last merged interval for as long as the
+  // next one continues it.
+  std::vector <Interval> removed;
+  std::vector <Interval> merged;
+  for (size_t i = 0; i < tracked.size (); )
+  {
+    Interval run {tracked[i]};
+    size_t next = i + 1;
+    while (next < tracked.size () &&
+           tracked[next].start == run.end &&
+           tracked[next].tags () == run.tags () &&
+           tracked[next].getAnnotation () == run.getAnnotation () &&
+           ! boundaries.count (run.end))
+    {
+      run.end = tracked[next].end;
+      ++next;
+    }
+
+    if (next - i > 1)
+    {
+      removed.insert (removed.end (), tracked.begin () + i, tracked.begin () + next);
+      merged.push_back (run);
+    }
+
+    i = next;
+  }
+
+  if (! removed.empty ())
+  {
+    journal.startTransaction ();
+
+    database.deleteIntervals (removed);
+    for (auto& interval : merged)
+    {
+      database.addInterval (interval, verbose);
+    }
+
+    journal.endTransaction ();
+  }
+
+  if (verbose)
+  {
+    std::cout << "Compacted " << tracked.size ()
+              << (tracked.size () == 1 ? " interval" : " intervals")
+              << " into " << tracked.size () - removed.size () + merged.size () << ".\n";
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <commands.h>
+#include <Clock.h>
 #include <format.h>
 #include <timew.h>
 #include <iostream>
@@ -38,7 +39,7 @@ int CmdContinue (
   Journal& journal)
 {
   const bool verbose = rules.getBoolean ("verbose");
-  const Datetime now {};
+  const auto& now = Clock::now ();
 
   auto filter = cli.getFilter ({ now, 0 });
 
@@ -111,7 +112,7 @@ int CmdContinue (
   }
   else
   {
-    start_time = Datetime ();
+    start_time = now;
     end_time = 0;
   }
 
@@ -24,18 +24,71 @@
 //
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <format.h>
 #include <commands.h>
 #include <timew.h>
 #include <iostream>
 
 ////////////////////////////////////////////////////////////////////////////////
+// The changes after the change numbered cursor, as a JSON array of objects with
+// the sequence number, and the interval before and after the change.
+static int exportChanges (
+  const CLI& cli,
+  Database& database,
+  const std::string& cursor)
+{
+  if (cursor.empty () ||
+      cursor.find_first_not_of ("0123456789") != std::string::npos)
+  {
+    throw format ("'{1}' is not a valid sequence number.", cursor);
+  }
+
+  if (cli.getWords ().size () > 1)
+  {
+    throw std::string ("A change cursor cannot be combined with a filter.");
+  }
+
+  std::cout << "[\n";
+  int counter = 0;
+  for (auto& change : database.changesSince (std::stoll (cursor)))
+  {
+    if (counter)
+      std::cout << ",\n";
+
+    std::cout << change;
+    ++counter;
+  }
+
+  if (counter)
+    std::cout << '\n';
+
+  std::cout << "]\n";
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Support:
+//   timew export [<interval>] [<tag> ...]
+//   timew export since:<seq>
 int CmdExport (
   const CLI& cli,
   Rules& rules,
   Database& database)
 {
+  for (auto& word : cli.getWords ())
+  {
+    if (word.compare (0, 6, "since:") == 0)
+    {
+      return exportChanges (cli, database, word.substr (6));
+    }
+  }
+
   auto filter = cli.getFilter ();
-  std::cout << jsonFromIntervals (getTracked (database, rules, filter));
+  auto expression = cli.getTagExpression ();
+  auto words = cli.getAnnotationWords ();
+
+  database.snapshot ();
+  std::cout << jsonFromIntervals (getAllTracked (database, rules, filter, expression, words));
   return 0;
 }
 
@@ -28,6 +28,7 @@
 #include <Duration.h>
 #include <format.h>
 #include <commands.h>
+#include <Clock.h>
 #include <timew.h>
 #include <iostream>
 
@@ -46,7 +47,7 @@ int CmdGaps (
     if (rules.has ("reports.gaps.range"))
       expandIntervalHint (rules.get ("reports.gaps.range"), filter);
     else
-      filter.setRange (Datetime ("today"), Datetime ("tomorrow"));
+      filter.setRange (Clock::today (), Clock::tomorrow ());
   }
 
   // Is the :blank hint being used?
@@ -56,7 +57,10 @@ int CmdGaps (
   if (blank)
     untracked = subtractRanges ({filter}, getAllExclusions (rules, filter));
   else
+  {
+    database.snapshot ();
     untracked = getUntracked (database, rules, filter);
+  }
 
   Table table;
   table.width (1024);
@@ -93,7 +97,7 @@ int CmdGaps (
       // Intersect track with day.
       auto today = day_range.intersect (gap);
       if (gap.is_open ())
-        today.end = Datetime ();
+        today.end = Clock::now ();
 
       table.set (row, 3, today.start.toString ("h:N:S"));
       table.set (row, 4, (gap.is_open () ? "-" : today.end.toString ("h:N:S")));
@@ -40,11 +40,13 @@ int CmdGet (
   std::vector <std::string> results;
   std::vector <std::string> references = cli.getDomReferences ();
   Interval filter = cli.getFilter ();
+  TagExpression expression = cli.getTagExpression ();
+  auto words = cli.getAnnotationWords ();
 
   for (auto& reference : references)
   {
     std::string value;
-    if (! domGet (database, filter, rules, reference, value))
+    if (! domGet (database, filter, rules, reference, value, expression, words))
       throw format ("DOM reference '{1}' is not valid.", reference);
 
     results.push_back (value);
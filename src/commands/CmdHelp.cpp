@@ -41,12 +41,15 @@ int CmdHelpUsage (const Extensions& extensions)
             << "Usage: timew [--version]\n"
             << "       timew annotate @<id> [@<id> ...] <annotation>\n"
             << "       timew cancel\n"
+            << "       timew check\n"
+            << "       timew compact [<interval>] [:exclusions]\n"
             << "       timew config [<name> [<value> | '']]\n"
             << "       timew continue [@<id>] [<date>|<interval>]\n"
             << "       timew day [<interval>] [<tag> ...]\n"
             << "       timew delete @<id> [@<id> ...]\n"
             << "       timew diagnostics\n"
             << "       timew export [<interval>] [<tag> ...]\n"
+            << "       timew export since:<seq>\n"
             << "       timew extensions\n"
             << "       timew gaps [<interval>] [<tag> ...]\n"
             << "       timew get <DOM> [<DOM> ...]\n"
@@ -56,17 +59,23 @@ int CmdHelpUsage (const Extensions& extensions)
             << "       timew modify (start|end) @<id> <date>\n"
             << "       timew month [<interval>] [<tag> ...]\n"
             << "       timew move @<id> <date>\n"
+            << "       timew purge before:<date>\n"
             << "       timew [report] <report> [<interval>] [<tag> ...]\n"
+            << "       timew shift <interval> [back] <duration>\n"
             << "       timew shorten @<id> [@<id> ...] <duration>\n"
             << "       timew show\n"
             << "       timew split @<id> [@<id> ...]\n"
             << "       timew start [<date>] [<tag> ...]\n"
+            << "       timew stats [:json]\n"
             << "       timew stop [<tag> ...]\n"
             << "       timew summary [<interval>] [<tag> ...]\n"
+            << "       timew sync <directory>\n"
             << "       timew tag @<id> [@<id> ...] <tag> [<tag> ...]\n"
             << "       timew tags [<interval>] [<tag> ...]\n"
+            << "       timew tags rename <tag> <new>\n"
+            << "       timew tags merge <tag> [<tag> ...] <into>\n"
             << "       timew track <interval> [<tag> ...]\n"
-            << "       timew undo\n"
+            << "       timew undo [<count>]\n"
             << "       timew untag @<id> [@<id> ...] <tag> [<tag> ...]\n"
             << "       timew week [<interval>] [<tag> ...]\n"
             << '\n';
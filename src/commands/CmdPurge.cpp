@@ -0,0 +1,88 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <Datetime.h>
+#include <format.h>
+#include <shared.h>
+#include <commands.h>
+#include <timew.h>
+#include <iostream>
+
+////////////////////////////////////////////////////////////////////////////////
+// Support:
+//   timew purge before:<date>
+//   timew purge before <date>
+int CmdPurge (
+  const CLI& cli,
+  Rules& rules,
+  Database& database)
+{
+  const bool verbose = rules.getBoolean ("verbose");
+
+  auto words = cli.getWords ();
+  std::string date;
+  if (words.size () == 1 && words[0].compare (0, 7, "before:") == 0)
+  {
+    date = words[0].substr (7);
+  }
+  else if (words.size () == 2 && words[0] == "before")
+  {
+    date = words[1];
+  }
+
+  if (date.empty ())
+  {
+    throw std::string ("A date must be specified. See 'timew help purge'.");
+  }
+
+  Datetime cutoff (date);
+
+  if (rules.getBoolean ("confirmation") &&
+      ! confirm (format ("Are you sure you want to permanently delete all tracked time before {1}?",
+                         cutoff.toISOLocalExtended ())))
+  {
+    if (verbose)
+    {
+      std::cout << "No changes made.\n";
+    }
+
+    return 0;
+  }
+
+  // Purged time cannot be restored, so the purge is not journaled.
+  auto count = database.purge (cutoff);
+
+  if (verbose)
+  {
+    std::cout << "Purged " << count << (count == 1 ? " interval" : " intervals")
+              << " before " << cutoff.toISOLocalExtended () << ".\n";
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
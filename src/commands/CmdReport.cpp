@@ -91,7 +91,8 @@ int CmdReport (
 
   // Compose Header info.
   auto filter = cli.getFilter ();
-  auto tracked = getTracked (database, rules, filter);
+  database.snapshot ();
+  auto tracked = getAllTracked (database, rules, filter);
 
   rules.set ("temp.report.start", filter.is_started () ? filter.start.toISO () : "");
   rules.set ("temp.report.end",   filter.is_ended ()   ? filter.end.toISO ()   : "");
@@ -0,0 +1,180 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <Duration.h>
+#include <format.h>
+#include <commands.h>
+#include <timew.h>
+#include <algorithm>
+#include <iostream>
+
+////////////////////////////////////////////////////////////////////////////////
+// Support:
+//   timew shift <range> <duration>         # later by <duration>
+//   timew shift <range> back <duration>    # earlier by <duration>
+//
+// All intervals starting within the range are moved in one operation.
+int CmdShift (
+  const CLI& cli,
+  Rules& rules,
+  Database& database,
+  Journal& journal)
+{
+  const bool verbose = rules.getBoolean ("verbose");
+
+  // The last duration is the amount to shift by, which is not part of the
+  // range.
+  CLI range {cli};
+  auto amount = std::find_if (range._args.rbegin (), range._args.rend (), [] (const A2& arg)
+  {
+    return arg.hasTag ("FILTER") && arg._lextype == Lexer::Type::duration;
+  });
+
+  if (amount == range._args.rend ())
+  {
+    throw std::string ("A duration must be specified. See 'timew help shift'.");
+  }
+
+  int seconds = Duration (amount->attribute ("raw")).toTime_t ();
+  auto first = std::next (amount).base ();
+  auto last = amount.base ();
+  if (std::next (amount) != range._args.rend () &&
+      std::next (amount)->attribute ("raw") == "back")
+  {
+    seconds = -seconds;
+    --first;
+  }
+
+  range._args.erase (first, last);
+
+  Interval filter = range.getFilter ();
+  if (! filter.is_started ())
+  {
+    throw std::string ("A range must be specified. See 'timew help shift'.");
+  }
+
+  std::vector <Interval> intervals;
+  for (auto& interval : getTracked (database, rules, filter))
+  {
+    if (interval.start >= filter.start &&
+        (! filter.is_ended () || interval.start < filter.end))
+    {
+      if (interval.is_open ())
+      {
+        throw format ("Cannot shift open interval @{1}", interval.id);
+      }
+
+      intervals.push_back (interval);
+    }
+  }
+
+  if (intervals.empty ())
+  {
+    if (verbose)
+    {
+      std::cout << "No intervals to shift.\n";
+    }
+
+    return 0;
+  }
+
+  std::sort (intervals.begin (), intervals.end (), [] (const Interval& a, const Interval& b)
+  {
+    return a.start < b.start;
+  });
+
+  std::vector <Interval> shifted {intervals};
+  for (auto& interval : shifted)
+  {
+    interval.start += seconds;
+    interval.end += seconds;
+  }
+
+  // The shifted intervals keep their distances, so they can only overlap
+  // intervals that were not shifted with them, at the edges of the block.
+  std::set <std::string> moved;
+  for (auto& interval : intervals)
+  {
+    moved.insert (interval.serialize ());
+  }
+
+  Interval block {shifted.front ().start, shifted.back ().end};
+
+  for (auto& other : getTracked (database, rules, block))
+  {
+    if (moved.count (other.serialize ()))
+    {
+      continue;
+    }
+
+    bool overlaps = block.end > other.start;
+    if (! other.is_open ())
+    {
+      // The last shifted interval starting before the other ends is the only
+      // one that may overlap it.
+      auto after = std::upper_bound (shifted.begin (), shifted.end (), other.end, [] (const Datetime& end, const Interval& interval)
+      {
+        return end <= interval.start;
+      });
+
+      overlaps = after != shifted.begin () && std::prev (after)->end > other.start;
+    }
+
+    if (overlaps)
+    {
+      throw format ("Shifting would overlap @{1}.", other.id);
+    }
+  }
+
+  journal.startTransaction ();
+
+  // All intervals are removed before any is added back, possibly in another
+  // data file, so that each data file is written once.
+  for (auto& interval : intervals)
+  {
+    database.deleteInterval (interval);
+  }
+
+  for (auto& interval : shifted)
+  {
+    database.addInterval (interval, verbose);
+  }
+
+  journal.endTransaction ();
+
+  if (verbose)
+  {
+    std::cout << "Shifted " << intervals.size ()
+              << (intervals.size () == 1 ? " interval" : " intervals")
+              << (seconds < 0 ? " back" : "")
+              << " by " << Duration (std::abs (seconds)).formatHours () << ".\n";
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <commands.h>
+#include <Clock.h>
 #include <timew.h>
 #include <iostream>
 
@@ -36,15 +37,11 @@ int CmdStart (
   Journal& journal)
 {
   const bool verbose = rules.getBoolean ("verbose");
-  const Datetime now {};
+  const auto& now = Clock::now ();
 
   auto interval = cli.getFilter ({ now, 0 });
 
-  if (interval.start > now)
-  {
-    throw std::string ("Time tracking cannot be set in the future.");
-  }
-  else if (!interval.is_started () || interval.is_ended ())
+  if (!interval.is_started () || interval.is_ended ())
   {
     throw std::string ("The start command does not accept ranges but only a single datetime. "
                        "Perhaps you want the track command?");
@@ -58,9 +55,8 @@ int CmdStart (
   }
 
   journal.startTransaction ();
-  if (validate (cli, rules, database, interval))
+  if (startTracking (cli, rules, database, interval, verbose))
   {
-    database.addInterval (interval, verbose);
     journal.endTransaction ();
   }
   if (verbose)
@@ -0,0 +1,208 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <commands.h>
+#include <timew.h>
+#include <IntervalFactory.h>
+#include <FS.h>
+#include <Table.h>
+#include <Color.h>
+#include <Timer.h>
+#include <shared.h>
+#include <algorithm>
+#include <set>
+#include <sstream>
+#include <iostream>
+
+////////////////////////////////////////////////////////////////////////////////
+struct MonthStats
+{
+  std::string  month     {};
+  size_t       bytes     {0};
+  unsigned int intervals {0};
+  unsigned int open      {0};
+  unsigned int tags      {0};
+};
+
+////////////////////////////////////////////////////////////////////////////////
+static size_t averageLine (size_t bytes, unsigned int lines)
+{
+  return lines ? bytes / lines : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Support:
+//   timew stats [:json]
+//
+// Reads every data file once, outside of the database, so that the figures
+// describe the files as they are stored, and times the parsing of the lines.
+int CmdStats (
+  const CLI& cli,
+  Rules& rules,
+  Database& database)
+{
+  const std::string data = rules.get ("temp.db") + "/data";
+
+  std::vector <MonthStats> months;
+  std::set <std::string> tags;
+  size_t bytes = 0;
+  unsigned int intervals = 0;
+  unsigned int open = 0;
+  unsigned long parsing = 0;
+
+  for (auto& name : database.files ())
+  {
+    std::string contents;
+    if (! File::read (data + '/' + name, contents))
+    {
+      continue;
+    }
+
+    MonthStats month;
+    month.month = name.substr (0, name.find ('.'));
+    month.bytes = contents.size ();
+
+    std::set <std::string> monthTags;
+    Timer timer;
+    for (auto& line : split (contents, '\n'))
+    {
+      if (line.empty ())
+      {
+        continue;
+      }
+
+      auto interval = IntervalFactory::fromSerialization (line);
+      ++month.intervals;
+      if (interval.is_open ())
+      {
+        ++month.open;
+      }
+
+      for (auto& tag : interval.tags ())
+      {
+        monthTags.insert (tag);
+      }
+    }
+    timer.stop ();
+    parsing += timer.total_us ();
+
+    month.tags = monthTags.size ();
+    tags.insert (monthTags.begin (), monthTags.end ());
+    bytes += month.bytes;
+    intervals += month.intervals;
+    open += month.open;
+    months.push_back (month);
+  }
+
+  // The journal is a sequence of transactions, each starting with 'txn:'.
+  std::vector <std::string> journal;
+  File::read (data + "/undo.data", journal);
+  size_t journalBytes = 0;
+  unsigned int transactions = 0;
+  for (auto& line : journal)
+  {
+    journalBytes += line.size () + 1;
+    if (line == "txn:")
+    {
+      ++transactions;
+    }
+  }
+
+  // Intervals parsed per second, over all the files.
+  unsigned long rate = intervals * 1000000UL / std::max (parsing, 1UL);
+
+  if (findHint (cli, ":json"))
+  {
+    std::stringstream out;
+    out << "{\"months\":[";
+    for (unsigned int i = 0; i < months.size (); ++i)
+    {
+      auto& month = months[i];
+      out << (i ? ",\n" : "\n")
+          << "{\"month\":\"" << month.month << '"'
+          << ",\"bytes\":" << month.bytes
+          << ",\"intervals\":" << month.intervals
+          << ",\"open\":" << month.open
+          << ",\"tags\":" << month.tags
+          << ",\"averageLine\":" << averageLine (month.bytes, month.intervals)
+          << '}';
+    }
+
+    out << "\n],\n"
+        << "\"bytes\":" << bytes
+        << ",\"intervals\":" << intervals
+        << ",\"open\":" << open
+        << ",\"tags\":" << tags.size ()
+        << ",\"averageLine\":" << averageLine (bytes, intervals)
+        << ",\"journal\":{\"bytes\":" << journalBytes << ",\"transactions\":" << transactions << '}'
+        << ",\"parseRate\":" << rate
+        << "}\n";
+
+    std::cout << out.str ();
+    return 0;
+  }
+
+  Table table;
+  table.width (1024);
+  table.colorHeader (Color ("underline"));
+  table.add ("Month");
+  table.add ("Bytes", false);
+  table.add ("Intervals", false);
+  table.add ("Open", false);
+  table.add ("Tags", false);
+  table.add ("Avg line", false);
+
+  for (auto& month : months)
+  {
+    auto row = table.addRow ();
+    table.set (row, 0, month.month);
+    table.set (row, 1, std::to_string (month.bytes));
+    table.set (row, 2, static_cast <int> (month.intervals));
+    table.set (row, 3, static_cast <int> (month.open));
+    table.set (row, 4, static_cast <int> (month.tags));
+    table.set (row, 5, std::to_string (averageLine (month.bytes, month.intervals)));
+  }
+
+  std::cout << '\n';
+  if (! months.empty ())
+  {
+    std::cout << table.render ()
+              << '\n';
+  }
+
+  std::cout << "   Data files: " << months.size () << ", " << bytes << " bytes\n"
+            << "    Intervals: " << intervals << ", " << open << " open\n"
+            << "         Tags: " << tags.size () << '\n'
+            << "     Avg line: " << averageLine (bytes, intervals) << " bytes\n"
+            << "      Journal: " << journalBytes << " bytes, " << transactions << " transactions\n"
+            << "   Parse rate: " << rate << " intervals/s\n"
+            << '\n';
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
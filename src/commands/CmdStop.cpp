@@ -26,6 +26,7 @@
 
 #include <format.h>
 #include <commands.h>
+#include <Clock.h>
 #include <timew.h>
 #include <iostream>
 
@@ -48,7 +49,7 @@ int CmdStop (
   Journal& journal)
 {
   const bool verbose = rules.getBoolean ("verbose");
-  const Datetime now {};
+  const auto& now = Clock::now ();
 
   auto filter = cli.getFilter ({ now, 0 });
   // Load the most recent interval.
@@ -29,6 +29,7 @@
 #include <shared.h>
 #include <format.h>
 #include <commands.h>
+#include <Clock.h>
 #include <timew.h>
 #include <iostream>
 
@@ -36,6 +37,8 @@
 std::map <Datetime, std::string> createHolidayMap (Rules&, Interval&);
 std::string renderHolidays (const std::map <Datetime, std::string>&);
 
+std::string renderHierarchy (const std::map <std::string, time_t>&, const TagInfoDatabase&);
+
 ////////////////////////////////////////////////////////////////////////////////
 int CmdSummary (
   const CLI& cli,
@@ -45,10 +48,11 @@ int CmdSummary (
   const bool verbose = rules.getBoolean ("verbose");
 
   // Create a filter, and if empty, choose 'today'.
-  auto filter = cli.getFilter (Range { Datetime ("today"), Datetime ("tomorrow") });
+  auto filter = cli.getFilter (Range { Clock::today (), Clock::tomorrow () });
 
-  // Load the data.
-  auto tracked = getTracked (database, rules, filter);
+  // Load the data, all of one generation.
+  database.snapshot ();
+  auto tracked = getAllTracked (database, rules, filter, cli.getTagExpression (), cli.getAnnotationWords ());
 
   if (tracked.empty ())
   {
@@ -116,9 +120,10 @@ int CmdSummary (
   auto days_start = filter.is_started() ? filter.start : tracked.front ().start;
   auto days_end   = filter.is_ended()   ? filter.end   : tracked.back ().end;
 
+  const auto& now = Clock::now ();
   if (days_end == 0)
   {
-    days_end = Datetime ();
+    days_end = now;
   }
 
   for (Datetime day = days_start.startOfDay (); day < days_end; ++day)
@@ -130,7 +135,7 @@ int CmdSummary (
     for (auto& track : subset (day_range, tracked))
     {
       // Make sure the track only represents one day.
-      if ((track.is_open () && day > Datetime ()))
+      if ((track.is_open () && day > now))
         continue;
 
       row = table.addRow ();
@@ -145,8 +150,8 @@ int CmdSummary (
 
       // Intersect track with day.
       auto today = day_range.intersect (track);
-      if (track.is_open () && day <= Datetime () && today.end > Datetime ())
-        today.end = Datetime ();
+      if (track.is_open () && day <= now && today.end > now)
+        today.end = now;
 
       std::string tags = join(", ", track.tags());
 
@@ -186,8 +191,17 @@ int CmdSummary (
 
   const auto with_holidays = rules.getBoolean ("reports.summary.holidays");
 
+  // The hierarchy is totalled from the intervals already loaded.
+  std::string hierarchy;
+  if (findHint (cli, ":hierarchy"))
+  {
+    auto tagInfoDatabase = database.tagHierarchy ();
+    hierarchy = '\n' + renderHierarchy (rollupTags (tracked, tagInfoDatabase, filter), tagInfoDatabase);
+  }
+
   std::cout << '\n'
             << table.render ()
+            << hierarchy
             << (with_holidays ? renderHolidays (createHolidayMap (rules, filter)) : "")
             << '\n';
 
@@ -211,3 +225,47 @@ std::string renderHolidays (const std::map<Datetime, std::string> &holidays)
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+static void addHierarchyRows (
+  Table& table,
+  const std::map <std::string, time_t>& totals,
+  const TagInfoDatabase& tagInfoDatabase,
+  const std::string& tag,
+  int depth)
+{
+  auto row = table.addRow ();
+  table.set (row, 0, std::string (2 * depth, ' ') + tag);
+  table.set (row, 1, Duration (totals.at (tag)).formatHours ());
+
+  for (auto& child : tagInfoDatabase.children (tag))
+  {
+    if (totals.count (child))
+    {
+      addHierarchyRows (table, totals, tagInfoDatabase, child, depth + 1);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Render the totals as a tree, each tag below its parent.
+std::string renderHierarchy (
+  const std::map <std::string, time_t>& totals,
+  const TagInfoDatabase& tagInfoDatabase)
+{
+  Table table;
+  table.width (1024);
+  table.colorHeader (Color ("underline"));
+  table.add ("Tag");
+  table.add ("Total", false);
+
+  for (auto& total : totals)
+  {
+    if (tagInfoDatabase.ancestors (total.first).empty ())
+    {
+      addHierarchyRows (table, totals, tagInfoDatabase, total.first, 0);
+    }
+  }
+
+  return table.render ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,443 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <AtomicFile.h>
+#include <FS.h>
+#include <IntervalFactory.h>
+#include <format.h>
+#include <shared.h>
+#include <commands.h>
+#include <timew.h>
+#include <algorithm>
+#include <ctime>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <sstream>
+#include <sys/stat.h>
+
+// A month as both databases had it after the last sync: the hash of its lines,
+// and the size and modification time of its file on each side.
+struct SyncedMonth
+{
+  std::string hash;
+  long long   localSize;
+  long long   localTime;
+  long long   remoteSize;
+  long long   remoteTime;
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// A missing file has size -1.
+static void fileStat (const std::string& path, long long& size, long long& time)
+{
+  struct stat s;
+  if (::stat (path.c_str (), &s) == 0)
+  {
+    size = s.st_size;
+    time = s.st_mtime;
+  }
+  else
+  {
+    size = -1;
+    time = 0;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The intervals of a month file, sorted as the file stores them.
+static std::vector <std::string> readMonth (const std::string& path)
+{
+  std::vector <std::string> lines;
+  if (File (path).exists ())
+  {
+    File::read (path, lines);
+  }
+
+  lines.erase (std::remove (lines.begin (), lines.end (), ""), lines.end ());
+  std::sort (lines.begin (), lines.end ());
+  return lines;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The months of the data files in a directory, as 'YYYY-MM'.
+static void listMonths (const std::string& location, std::set <std::string>& months)
+{
+  Directory directory (location);
+  if (! directory.is_directory ())
+  {
+    return;
+  }
+
+  for (auto& file : directory.list ())
+  {
+    auto name = Path (file).name ();
+    if (name.length () == 12 &&
+        name[4] == '-' &&
+        name.compare (7, 5, ".data") == 0)
+    {
+      months.insert (name.substr (0, 7));
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The state file holds the time it was written, then one line per month.
+static std::map <std::string, SyncedMonth> loadState (const std::string& path, long long& written)
+{
+  std::map <std::string, SyncedMonth> state;
+  written = 0;
+
+  std::vector <std::string> lines;
+  if (! File (path).exists () || ! File::read (path, lines) || lines.empty ())
+  {
+    return state;
+  }
+
+  written = std::strtoll (lines[0].c_str (), nullptr, 10);
+  for (size_t i = 1; i < lines.size (); ++i)
+  {
+    std::istringstream in (lines[i]);
+    std::string month;
+    SyncedMonth synced;
+    if (in >> month >> synced.hash >> synced.localSize >> synced.localTime >> synced.remoteSize >> synced.remoteTime)
+    {
+      state[month] = synced;
+    }
+  }
+
+  return state;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Replaced by rename, so that an interrupted write leaves the previous state.
+static void saveState (const std::string& path, const std::map <std::string, SyncedMonth>& state, long long written)
+{
+  std::stringstream out;
+  out << written << '\n';
+  for (auto& month : state)
+  {
+    out << month.first << ' '
+        << month.second.hash << ' '
+        << month.second.localSize << ' '
+        << month.second.localTime << ' '
+        << month.second.remoteSize << ' '
+        << month.second.remoteTime << '\n';
+  }
+
+  auto temp = path + ".tmp";
+  if (! File::write (temp, out.str ()) ||
+      ::rename (temp.c_str (), path.c_str ()) != 0)
+  {
+    throw format ("Could not write to '{1}'", path);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// A three-way merge of the lines of a month: a line is kept if both sides have
+// it, or one side added it since the last sync, and dropped if either side
+// deleted it. A changed interval is a deleted line and an added one.
+static std::vector <std::string> mergeLines (
+  const std::vector <std::string>& base,
+  const std::vector <std::string>& local,
+  const std::vector <std::string>& remote)
+{
+  std::set <std::string> before (base.begin (), base.end ());
+  std::set <std::string> theirs (remote.begin (), remote.end ());
+
+  std::set <std::string> merged;
+  for (auto& line : local)
+  {
+    if (theirs.count (line) || ! before.count (line))
+    {
+      merged.insert (line);
+    }
+  }
+
+  for (auto& line : remote)
+  {
+    if (! before.count (line))
+    {
+      merged.insert (line);
+    }
+  }
+
+  return {merged.begin (), merged.end ()};
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Both sides changed the same time, as when both changed one interval.
+static bool overlapping (const std::vector <std::string>& lines)
+{
+  std::vector <Interval> intervals;
+  for (auto& line : lines)
+  {
+    intervals.push_back (IntervalFactory::fromSerialization (line));
+  }
+
+  std::sort (intervals.begin (), intervals.end (), [] (const Interval& a, const Interval& b)
+  {
+    return a.start < b.start;
+  });
+
+  for (size_t i = 1; i < intervals.size (); ++i)
+  {
+    if (intervals[i - 1].is_open () || intervals[i].start < intervals[i - 1].end)
+    {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Change the intervals of a month in database from lines to result.
+static void applyLines (
+  Database& database,
+  const std::vector <std::string>& lines,
+  const std::vector <std::string>& result)
+{
+  std::vector <std::string> removed;
+  std::set_difference (lines.begin (), lines.end (), result.begin (), result.end (),
+                       std::back_inserter (removed));
+
+  std::vector <std::string> added;
+  std::set_difference (result.begin (), result.end (), lines.begin (), lines.end (),
+                       std::back_inserter (added));
+
+  for (auto& line : removed)
+  {
+    database.deleteInterval (IntervalFactory::fromSerialization (line));
+  }
+
+  for (auto& line : added)
+  {
+    database.addInterval (IntervalFactory::fromSerialization (line), false);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Support:
+//   timew sync <directory>
+//
+// Brings the database and the one in directory to the same intervals. Months
+// whose files kept their size and modification time on both sides since the
+// last sync are not read. A month changed on one side only is copied to the
+// other, and one changed on both is merged against its lines at the last sync,
+// which are kept for that. Months where both sides changed the same time are
+// left as they are.
+int CmdSync (
+  const CLI& cli,
+  Rules& rules,
+  Database& database,
+  Journal& journal)
+{
+  const bool verbose = rules.getBoolean ("verbose");
+
+  auto words = cli.getWords ();
+  if (words.size () != 1)
+  {
+    throw std::string ("A database directory must be specified. See 'timew help sync'.");
+  }
+
+  Directory local (rules.get ("temp.db"));
+  Directory other (words[0]);
+  if (! other.is_directory ())
+  {
+    throw format ("'{1}' is not a directory.", words[0]);
+  }
+
+  if (other._data == local._data)
+  {
+    throw std::string ("A database cannot be synced with itself.");
+  }
+
+  auto localData = local._data + "/data";
+  Directory remoteData (other._data + "/data");
+  if (! remoteData.exists ())
+  {
+    remoteData.create (0700);
+  }
+
+  // The lines of each month at the last sync are kept per remote directory.
+  Directory syncDir (localData + "/sync");
+  if (! syncDir.exists ())
+  {
+    syncDir.create (0700);
+  }
+
+  auto stateDir = syncDir._data + "/" + contentHash (other._data);
+  Directory (stateDir).create (0700);
+
+  long long written;
+  auto state = loadState (stateDir + "/state", written);
+
+  std::set <std::string> months;
+  listMonths (localData, months);
+  listMonths (remoteData._data, months);
+  for (auto& month : state)
+  {
+    months.insert (month.first);
+  }
+
+  // The other database is changed without journaling. The files of both are
+  // replaced in one commit here, logged in the local commit log.
+  Journal remoteJournal;
+  remoteJournal.initialize (remoteData._data + "/undo.data", -1);
+  Database remote;
+  remote.initialize (remoteData._data, remoteJournal, false);
+
+  std::map <std::string, SyncedMonth> synced;
+  std::vector <std::string> conflicts;
+  unsigned int copied = 0;
+  unsigned int merged = 0;
+  bool journaled = false;
+
+  for (auto& month : months)
+  {
+    auto localPath = localData + "/" + month + ".data";
+    auto remotePath = remoteData._data + "/" + month + ".data";
+    auto basePath = stateDir + "/" + month + ".data";
+
+    SyncedMonth now {};
+    fileStat (localPath, now.localSize, now.localTime);
+    fileStat (remotePath, now.remoteSize, now.remoteTime);
+
+    // A file changed within the second the state was written may have kept
+    // its time, so it is only trusted if it is older.
+    auto last = state.find (month);
+    if (last != state.end () &&
+        now.localSize  == last->second.localSize  && now.localTime  == last->second.localTime  &&
+        now.remoteSize == last->second.remoteSize && now.remoteTime == last->second.remoteTime &&
+        now.localTime < written && now.remoteTime < written)
+    {
+      synced[month] = last->second;
+      continue;
+    }
+
+    auto localLines = readMonth (localPath);
+    auto remoteLines = readMonth (remotePath);
+    auto localHash = contentHash (join ("\n", localLines));
+    auto remoteHash = contentHash (join ("\n", remoteLines));
+
+    // A month not synced before was empty on both sides then.
+    auto baseHash = last != state.end () ? last->second.hash : contentHash ("");
+
+    std::vector <std::string> result;
+    if (localHash == remoteHash)
+    {
+      result = localLines;
+    }
+    else if (localHash == baseHash)
+    {
+      result = remoteLines;
+      ++copied;
+    }
+    else if (remoteHash == baseHash)
+    {
+      result = localLines;
+      ++copied;
+    }
+    else
+    {
+      result = mergeLines (readMonth (basePath), localLines, remoteLines);
+      if (overlapping (result))
+      {
+        conflicts.push_back (month);
+        if (last != state.end ())
+        {
+          synced[month] = last->second;
+        }
+
+        continue;
+      }
+
+      ++merged;
+    }
+
+    // Only the changes to this database can be undone.
+    if (result != localLines && ! journaled)
+    {
+      journal.startTransaction ();
+      journaled = true;
+    }
+
+    applyLines (database, localLines, result);
+    applyLines (remote, remoteLines, result);
+
+    if (result.empty ())
+    {
+      AtomicFile base (basePath);
+      if (base.exists ())
+      {
+        base.remove ();
+      }
+    }
+    else
+    {
+      AtomicFile::write (Path (basePath), result);
+      synced[month] = SyncedMonth {contentHash (join ("\n", result)), 0, 0, 0, 0};
+    }
+  }
+
+  if (journaled)
+  {
+    journal.endTransaction ();
+  }
+
+  // Both databases are replaced in one commit, within a new generation of each.
+  database.commit ();
+  remote.commit ();
+  database.publish (remoteData._data);
+
+  written = static_cast <long long> (::time (nullptr));
+  for (auto& month : synced)
+  {
+    fileStat (localData + "/" + month.first + ".data", month.second.localSize, month.second.localTime);
+    fileStat (remoteData._data + "/" + month.first + ".data", month.second.remoteSize, month.second.remoteTime);
+  }
+
+  saveState (stateDir + "/state", synced, written);
+
+  if (verbose)
+  {
+    std::cout << "Synced with " << other._data << ": "
+              << copied << (copied == 1 ? " month" : " months") << " copied, "
+              << merged << " merged.\n";
+  }
+
+  for (auto& month : conflicts)
+  {
+    std::cout << "Both databases changed the same time in " << month << ", which was not synced.\n";
+  }
+
+  return conflicts.empty () ? 0 : 1;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -29,23 +29,77 @@
 #include <timew.h>
 #include <Table.h>
 #include <Color.h>
+#include <format.h>
 #include <set>
 #include <iostream>
 
+////////////////////////////////////////////////////////////////////////////////
+// Support:
+//   timew tags rename <old> <new>                  # <new> must be unused
+//   timew tags merge <tag> [<tag> ...] <into>
+static int renameTags (
+  const std::vector <std::string>& words,
+  Rules& rules,
+  Database& database,
+  Journal& journal)
+{
+  const bool verbose = rules.getBoolean ("verbose");
+  const bool rename = words[0] == "rename";
+
+  if (rename ? words.size () != 3 : words.size () < 3)
+  {
+    throw format ("The 'tags {1}' command requires {2}.",
+                  words[0],
+                  rename ? "an old and a new tag" : "the tags to merge and the tag to merge them into");
+  }
+
+  std::set <std::string> from (words.begin () + 1, words.end () - 1);
+  const std::string& to = words.back ();
+  from.erase (to);
+
+  if (from.empty ())
+  {
+    throw format ("The tag '{1}' cannot be merged into itself.", to);
+  }
+
+  journal.startTransaction ();
+
+  auto count = rename ? database.renameTag (*from.begin (), to)
+                      : database.mergeTags (from, to);
+
+  journal.endTransaction ();
+
+  if (verbose)
+  {
+    std::cout << (rename ? "Renamed" : "Merged")
+              << " tags in " << count << (count == 1 ? " interval" : " intervals") << ".\n";
+  }
+
+  return 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 int CmdTags (
   const CLI& cli,
   Rules& rules,
-  Database& database)
+  Database& database,
+  Journal& journal)
 {
   const bool verbose = rules.getBoolean ("verbose");
 
+  auto words = cli.getWords ();
+  if (! words.empty () && (words[0] == "rename" || words[0] == "merge"))
+  {
+    return renameTags (words, rules, database, journal);
+  }
+
   // Create a filter, with no default range.
   auto filter = cli.getFilter ();
 
   // Generate a unique, ordered list of tags.
+  database.snapshot ();
   std::set <std::string> tags;
-  for (const auto& interval : getTracked (database, rules, filter))
+  for (const auto& interval : getTracked (database, rules, filter, cli.getTagExpression (), cli.getAnnotationWords ()))
     for (auto& tag : interval.tags ())
       tags.insert (tag);
 
@@ -30,12 +30,20 @@
 #include <format.h>
 #include <IntervalFactory.h>
 
-static void undoIntervalAction(UndoAction& action, Database& database)
+// An interval as it is now, and as it is to be after undoing. Undoing several
+// transactions that change the same interval only applies the net change.
+struct IntervalChange
 {
-  Interval before = IntervalFactory::fromJson (action.getBefore ());
-  Interval after = IntervalFactory::fromJson (action.getAfter ());
+  std::string from;
+  std::string to;
+};
 
-  database.modifyInterval (after, before, false);
+static void undoIntervalChange (const IntervalChange& change, Database& database)
+{
+  Interval from = IntervalFactory::fromJson (change.from);
+  Interval to = IntervalFactory::fromJson (change.to);
+
+  database.modifyInterval (from, to, false);
 }
 
 static void undoConfigAction (UndoAction& action, Rules &rules, Journal& journal)
@@ -59,25 +67,86 @@ static void undoConfigAction (UndoAction& action, Rules &rules, Journal& journal
   }
 }
 
-////////////////////////////////////////////////////////////////////////////////
-int CmdUndo (Rules& rules, Database& database, Journal& journal)
+static std::string intervalKey (const std::string& json)
 {
-  const bool verbose = rules.getBoolean ("verbose");
+  // Ids in the journal are those of the time of recording, so intervals are
+  // identified by their serialization.
+  return json.empty () ? "" : IntervalFactory::fromJson (json).serialize ();
+}
 
-  Transaction transaction = journal.popLastTransaction ();
+static void composeIntervalAction (UndoAction& action, std::vector <IntervalChange>& changes)
+{
+  const std::string& after = action.getAfter ();
+  const std::string& before = action.getBefore ();
 
-  std::vector <UndoAction> actions = transaction.getActions ();
+  if (! after.empty ())
+  {
+    auto key = intervalKey (after);
+    for (auto change = changes.rbegin (); change != changes.rend (); ++change)
+    {
+      if (! change->to.empty () && intervalKey (change->to) == key)
+      {
+        change->to = before;
+        return;
+      }
+    }
+  }
 
-  if (actions.empty ())
+  changes.push_back ({after, before});
+}
+
+static void applyIntervalChanges (std::vector <IntervalChange>& changes, Database& database)
+{
+  for (auto& change : changes)
   {
-    // No (more) undoing...
-    if (verbose)
+    if (intervalKey (change.from) != intervalKey (change.to))
     {
-      std::cout << "Nothing to undo." << std::endl;
+      undoIntervalChange (change, database);
     }
   }
-  else
+
+  changes.clear ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int CmdUndo (
+  const CLI& cli,
+  Rules& rules,
+  Database& database,
+  Journal& journal)
+{
+  const bool verbose = rules.getBoolean ("verbose");
+
+  // Support:
+  //   timew undo      # undo the last transaction
+  //   timew undo N    # undo the last N transactions
+  int count = 1;
+  auto words = cli.getWords ();
+  if (! words.empty ())
+  {
+    if (words.size () > 1 ||
+        words[0].empty () ||
+        words[0].size () > 9 ||
+        words[0].find_first_not_of ("0123456789") != std::string::npos ||
+        (count = std::stoi (words[0])) < 1)
+    {
+      throw std::string ("The 'undo' command takes an optional positive number of transactions.");
+    }
+  }
+
+  std::vector <Transaction> transactions = journal.popLastTransactions (count);
+  std::vector <IntervalChange> changes;
+  int undone = 0;
+
+  for (auto& transaction : transactions)
   {
+    std::vector <UndoAction> actions = transaction.getActions ();
+
+    if (actions.empty ())
+    {
+      continue;
+    }
+
     for (auto& action : actions)
     {
       // Select database...
@@ -86,25 +155,41 @@ int CmdUndo (Rules& rules, Database& database, Journal& journal)
       // Rollback action...
       if (type == "interval")
       {
-        undoIntervalAction (action, database);
+        composeIntervalAction (action, changes);
       }
       else if (type == "config")
       {
         undoConfigAction (action, rules, journal);
       }
+      else if (type == "tag")
+      {
+        // Later changes to intervals are undone before renaming them back.
+        applyIntervalChanges (changes, database);
+        database.renameTag (action.getAfter (), action.getBefore ());
+      }
       else
       {
         throw format ("Unknown undo action type '{1}'", type);
       }
     }
 
+    ++undone;
+  }
+
+  applyIntervalChanges (changes, database);
+
+  if (undone == 0)
+  {
+    // No (more) undoing...
     if (verbose)
     {
-      std::cout << "Undo" << std::endl;
+      std::cout << "Nothing to undo." << std::endl;
     }
   }
+  else if (verbose)
+  {
+    std::cout << "Undo" << std::endl;
+  }
 
   return 0;
 }
-
-////////////////////////////////////////////////////////////////////////////////
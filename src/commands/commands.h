@@ -35,6 +35,8 @@
 
 int CmdAnnotate      (const CLI&, Rules&, Database&, Journal&                   );
 int CmdCancel        (            Rules&, Database&, Journal&                   );
+int CmdCheck         (            Rules&, Database&                             );
+int CmdCompact       (const CLI&, Rules&, Database&, Journal&                   );
 int CmdConfig        (const CLI&, Rules&,            Journal&                   );
 int CmdContinue      (const CLI&, Rules&, Database&, Journal&                   );
 int CmdDefault       (            Rules&, Database&                             );
@@ -51,17 +53,21 @@ int CmdJoin          (const CLI&, Rules&, Database&, Journal&
 int CmdLengthen      (const CLI&, Rules&, Database&, Journal&                   );
 int CmdModify        (const CLI&, Rules&, Database&, Journal&                   );
 int CmdMove          (const CLI&, Rules&, Database&, Journal&                   );
+int CmdPurge         (const CLI&, Rules&, Database&                             );
 int CmdReport        (const CLI&, Rules&, Database&,           const Extensions&);
 int CmdResize        (const CLI&, Rules&, Database&, Journal&                   );
+int CmdShift         (const CLI&, Rules&, Database&, Journal&                   );
 int CmdShorten       (const CLI&, Rules&, Database&, Journal&                   );
 int CmdShow          (            Rules&                                        );
 int CmdSplit         (const CLI&, Rules&, Database&, Journal&                   );
 int CmdStart         (const CLI&, Rules&, Database&, Journal&                   );
+int CmdStats         (const CLI&, Rules&, Database&                             );
 int CmdStop          (const CLI&, Rules&, Database&, Journal&                   );
+int CmdSync          (const CLI&, Rules&, Database&, Journal&                   );
 int CmdTag           (const CLI&, Rules&, Database&, Journal&                   );
-int CmdTags          (const CLI&, Rules&, Database&                             );
+int CmdTags          (const CLI&, Rules&, Database&, Journal&                   );
 int CmdTrack         (const CLI&, Rules&, Database&, Journal&                   );
-int CmdUndo          (            Rules&, Database&, Journal&                   );
+int CmdUndo          (const CLI&, Rules&, Database&, Journal&                   );
 int CmdUntag         (const CLI&, Rules&, Database&, Journal&                   );
 
 int CmdChartDay      (const CLI&, Rules&, Database&                             );
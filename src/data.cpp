@@ -33,9 +33,15 @@
 #include <Datetime.h>
 #include <Duration.h>
 #include <timew.h>
+#include <Clock.h>
 #include <algorithm>
 #include <iostream>
 #include <IntervalFactory.h>
+#include <AnnotationIndex.h>
+#include <DayBitmap.h>
+#include <RangeBatch.h>
+#include <iterator>
+#include <numeric>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Read rules and extract all holiday definitions. Create a Range for each
@@ -135,7 +141,7 @@ std::vector <Interval> expandLatest (const Interval& latest, const Rules& rules)
   // If the latest interval is open, check for synthetic intervals
   if (latest.is_open ())
   {
-    auto exclusions = getAllExclusions (rules, {latest.start, Datetime ()});
+    auto exclusions = getAllExclusions (rules, {latest.start, Clock::now ()});
     if (! exclusions.empty ())
     {
       std::vector <Interval> flattened = flatten (latest, exclusions);
@@ -247,15 +253,49 @@ std::vector <Interval> getIntervalsByIds (
   return intervals;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Indices of the batch ranges that match the filter range, as matchesRange.
+static std::vector <unsigned int> selectMatchingRange (
+  const RangeBatch& batch,
+  const Range& filter)
+{
+  if (! filter.is_started () && ! filter.is_ended ())
+  {
+    std::vector <unsigned int> all (batch.size ());
+    std::iota (all.begin (), all.end (), 0);
+    return all;
+  }
+
+  return batch.intersecting (filter);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The start of a serialized interval, read without parsing the whole line.
+static Datetime serializedStart (const std::string& line)
+{
+  if (line.length () >= 20 &&
+      line.compare (0, 4, "inc ") == 0 &&
+      (line.length () == 20 || line[20] == ' '))
+  {
+    return Datetime (line.substr (4, 16));
+  }
+
+  return IntervalFactory::fromSerialization (line).start;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 std::vector <Interval> subset (
   const Interval& filter,
   const std::vector <Interval>& intervals)
 {
-  std::vector <Interval> all;
+  RangeBatch batch;
   for (auto& interval : intervals)
-    if (matchesFilter (interval, filter))
-      all.push_back (interval);
+    batch.add (interval);
+
+  std::vector <Interval> all;
+  for (auto i : selectMatchingRange (batch, filter))
+    if (matchesTags (intervals[i], filter))
+      all.push_back (intervals[i]);
 
   return all;
 }
@@ -266,11 +306,8 @@ std::vector <Range> subset (
   const std::vector <Range>& ranges)
 {
   std::vector <Range> all;
-  for (auto& r : ranges) {
-    if (range.intersects (r)) {
-      all.push_back (r);
-    }
-  }
+  for (auto i : RangeBatch (ranges).intersecting (range))
+    all.push_back (ranges[i]);
 
   return all;
 }
@@ -280,13 +317,13 @@ std::vector <Interval> subset (
   const Range& range,
   const std::vector <Interval>& intervals)
 {
+  RangeBatch batch;
+  for (auto& interval : intervals)
+    batch.add (interval);
+
   std::vector <Interval> all;
-  for (auto& interval : intervals) {
-    if (range.intersects (interval))
-    {
-      all.push_back (interval);
-    }
-  }
+  for (auto i : batch.intersecting (range))
+    all.push_back (intervals[i]);
 
   return all;
 }
@@ -299,11 +336,10 @@ std::vector <Interval> flatten (
   std::vector <Interval> all;
 
   std::vector <Range> enclosed;
-  for (auto& e : exclusions)
-    if (interval.encloses (e))
-      enclosed.push_back (e);
+  for (auto i : RangeBatch (exclusions).enclosedBy (interval))
+    enclosed.push_back (exclusions[i]);
 
-  Datetime now;
+  const auto& now = Clock::now ();
   for (auto& result : subtractRanges ({interval}, enclosed))
   {
     if (interval.is_open() && result.start > now)
@@ -379,12 +415,62 @@ std::vector <Range> addRanges (
   return results;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Whether subtractRanges can be done on a DayBitmap with the same result as with
+// Range::subtract. That is the case when the ranges are closed, not empty,
+// within one day, ascending and not adjacent, so that they are exactly the runs
+// of the bitmap, and when no subtraction is empty, because an empty subtraction
+// splits a range in two adjacent ones. The day is only looked up once the rest
+// holds, and the bitmap only built once it is known to be used.
+static bool bitmapSubtractable (
+  const std::vector <Range>& ranges,
+  const std::vector <Range>& subtractions)
+{
+  if (ranges.empty ())
+    return false;
+
+  for (unsigned int i = 0; i < ranges.size (); ++i)
+  {
+    if (! ranges[i].is_started () ||
+        ! ranges[i].is_ended () ||
+        ranges[i].start >= ranges[i].end ||
+        (i > 0 && ranges[i - 1].end >= ranges[i].start))
+      return false;
+  }
+
+  for (auto& subtraction : subtractions)
+  {
+    if (subtraction.is_started () &&
+        subtraction.is_ended () &&
+        subtraction.start >= subtraction.end)
+      return false;
+  }
+
+  // Ascending, so the ranges are within the day of the first if the last is.
+  auto day = getFullDay (ranges.front ().start);
+  return ranges.back ().end <= day.end;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Subtract a set of Ranges from another set of Ranges, all within a defined range.
 std::vector <Range> subtractRanges (
   const std::vector <Range>& ranges,
   const std::vector <Range>& subtractions)
 {
+  // Within a single day, such as for 'gaps :day', subtracting is clearing the
+  // seconds of a bitmap, regardless of the number of subtractions.
+  if (bitmapSubtractable (ranges, subtractions))
+  {
+    DayBitmap bitmap (ranges.front ().start);
+    for (auto& range : ranges)
+      bitmap.set (range);
+
+    for (auto& subtraction : subtractions)
+      bitmap.clear (subtraction);
+
+    return bitmap.ranges ();
+  }
+
   std::vector <Range> results = ranges;
   for (auto& s : subtractions)
   {
@@ -445,19 +531,57 @@ bool matchesRange (const Interval& interval, const Range& filter)
 //
 bool matchesFilter (const Interval& interval, const Interval& filter)
 {
-  if (matchesRange (interval, filter))
+  return matchesRange (interval, filter) &&
+         matchesTags (interval, filter);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// All filter interval tags are found in the interval.
+bool matchesTags (const Interval& interval, const Interval& filter)
+{
+  for (auto& tag : filter.tags ())
   {
-    for (auto& tag : filter.tags ())
+    if (! interval.hasTag (tag))
     {
-      if (! interval.hasTag (tag))
-      {
-        return false;
-      }
+      return false;
     }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// As above, and additionally the interval tags must satisfy the expression.
+bool matchesFilter (
+  const Interval& interval,
+  const Interval& filter,
+  const TagExpression& expression)
+{
+  return matchesFilter (interval, filter) &&
+         expression.matches (interval);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The annotation of the interval contains all the words.
+bool matchesAnnotation (
+  Interval& interval,
+  const std::vector <std::string>& words)
+{
+  if (words.empty ())
+  {
     return true;
   }
 
-  return false;
+  auto annotation = AnnotationIndex::tokenize (interval.getAnnotation ());
+  for (auto& word : words)
+  {
+    if (! std::binary_search (annotation.begin (), annotation.end (), word))
+    {
+      return false;
+    }
+  }
+
+  return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -480,17 +604,59 @@ Interval clip (const Interval& interval, const Range& range)
   return clipped;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// Total the time of the intervals per tag, and per ancestor of a tag, in one
+// pass over the intervals. An interval counts once towards an ancestor, even if
+// several of its tags share that ancestor. Only the time within the range is
+// counted, if the range is bounded.
+std::map <std::string, time_t> rollupTags (
+  const std::vector <Interval>& intervals,
+  const TagInfoDatabase& tagInfoDatabase,
+  const Range& range)
+{
+  std::map <std::string, time_t> totals;
+  bool bounded = range.is_started () && range.is_ended ();
+
+  for (auto& interval : intervals)
+  {
+    auto total = (bounded ? clip (interval, range) : interval).total ();
+
+    std::set <std::string> nodes;
+    for (auto& tag : interval.tags ())
+    {
+      nodes.insert (tag);
+      for (auto& ancestor : tagInfoDatabase.ancestors (tag))
+      {
+        nodes.insert (ancestor);
+      }
+    }
+
+    for (auto& node : nodes)
+    {
+      totals[node] += total;
+    }
+  }
+
+  return totals;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Return collection of intervals that match the filter (synthetic intervals
 // included) sorted by date
 std::vector <Interval> getTracked (
   Database& database,
   const Rules& rules,
-  Interval& filter)
+  Interval& filter,
+  const TagExpression& tagExpression,
+  const std::vector <std::string>& annotationWords)
 {
   int current_id = 0;
   std::vector <Interval> intervals;
 
+  // Each interval is matched on a small bitset rather than by comparing tag
+  // names.
+  auto& expression = tagExpression;
+
   auto it = database.begin ();
   auto end = database.end ();
 
@@ -504,7 +670,8 @@ std::vector <Interval> getTracked (
     for (auto& interval : expandLatest (latest, rules))
     {
       ++current_id;
-      if (matchesFilter (interval, filter))
+      if (matchesFilter (interval, filter, expression) &&
+          matchesAnnotation (interval, annotationWords))
       {
         interval.id = current_id;
         intervals.push_back (interval);
@@ -512,22 +679,105 @@ std::vector <Interval> getTracked (
     }
   }
 
-  for (; it != end; ++it)
+  // With an annotation index, only the lines containing the words are read.
+  // Their ids follow from their position, shifted by the synthetic intervals
+  // the latest interval was expanded into.
+  if (! annotationWords.empty () && database.hasAnnotationIndex ())
   {
-    Interval interval = IntervalFactory::fromSerialization(*it);
-    interval.id = ++current_id;
+    auto shift = current_id - 1;
+    for (auto& found : database.findAnnotated (annotationWords, filter))
+    {
+      if (found.first == 1)
+      {
+        continue;
+      }
 
-    if (matchesFilter (interval, filter))
+      Interval interval = IntervalFactory::fromSerialization (found.second);
+      interval.id = found.first + shift;
+
+      if (matchesFilter (interval, filter, expression) &&
+          matchesAnnotation (interval, annotationWords))
+      {
+        intervals.push_back (std::move (interval));
+      }
+    }
+
+    it = end;
+  }
+
+  // The files for the filter are read together, rather than as reached.
+  if (it != end)
+    database.preload (filter);
+
+  // The intervals are parsed in chunks, and the ranges of a chunk are matched
+  // against the filter in one batch. Chunks start small, because for recent
+  // ranges only a few intervals are needed, and grow for longer ranges.
+  std::vector <Interval> chunk;
+  RangeBatch batch;
+  unsigned int chunkSize = 32;
+  bool done = false;
+
+  while (! done && it != end)
+  {
+    chunk.clear ();
+    batch.clear ();
+
+    for (; it != end && chunk.size () < chunkSize; ++it)
     {
-      intervals.push_back (std::move (interval));
+      ++current_id;
+
+      // A line whose tags cannot match is not parsed. Only its start is read,
+      // to know when the intervals are past the filter.
+      if (! expression.matchesLine (*it))
+      {
+        if (serializedStart (*it) < filter.start)
+        {
+          done = true;
+          break;
+        }
+
+        continue;
+      }
+
+      chunk.push_back (IntervalFactory::fromSerialization (*it));
+      chunk.back ().id = current_id;
+      batch.add (chunk.back ());
+
+      // Intervals are in reverse order and do not overlap, so none after one
+      // that starts before the filter can match. The chunk ends here.
+      if (chunk.back ().start < filter.start)
+      {
+        done = true;
+        break;
+      }
     }
-    else if ((interval.start < filter.start) && ! interval.intersects (filter))
+
+    auto selected = selectMatchingRange (batch, filter);
+    auto next = selected.begin ();
+
+    for (unsigned int i = 0; i < chunk.size (); ++i)
     {
-      // Since we are moving backwards in time, and the intervals are in sorted
-      // order, if the filter is after the interval, we know there will be no
-      // more matches
-      break;
+      if (next != selected.end () && *next == i)
+      {
+        ++next;
+        if (matchesTags (chunk[i], filter) &&
+            expression.matches (chunk[i]) &&
+            matchesAnnotation (chunk[i], annotationWords))
+        {
+          intervals.push_back (std::move (chunk[i]));
+        }
+      }
+      else if (chunk[i].start < filter.start)
+      {
+        // Since we are moving backwards in time, and the intervals are in sorted
+        // order, if the filter is after the interval, we know there will be no
+        // more matches
+        done = true;
+        break;
+      }
     }
+
+    chunkSize = std::min (chunkSize * 2, 4096u);
   }
 
   debug (format ("Loaded {1} tracked intervals", intervals.size ()));
@@ -538,6 +788,44 @@ std::vector <Interval> getTracked (
   return intervals;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+// The tracked intervals of the database and of the databases mounted on it,
+// merged by date. Intervals of a mounted database keep the ids they have there,
+// and are marked with their source. Only reports use this, as mounted
+// intervals can neither be changed nor overlap the tracked ones.
+std::vector <Interval> getAllTracked (
+  Database& database,
+  const Rules& rules,
+  Interval& filter,
+  const TagExpression& tagExpression,
+  const std::vector <std::string>& annotationWords)
+{
+  auto intervals = getTracked (database, rules, filter, tagExpression, annotationWords);
+
+  for (auto& mounted : database.mounts ())
+  {
+    auto more = getTracked (*mounted, rules, filter, tagExpression, annotationWords);
+    for (auto& interval : more)
+    {
+      interval.source = mounted->source ();
+    }
+
+    std::vector <Interval> merged;
+    merged.reserve (intervals.size () + more.size ());
+    std::merge (intervals.begin (), intervals.end (),
+                more.begin (), more.end (),
+                std::back_inserter (merged),
+                [] (const Interval& a, const Interval& b)
+                {
+                  return a.start < b.start;
+                });
+
+    intervals.swap (merged);
+  }
+
+  return intervals;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // Untracked time is that which is not excluded, and not filled. Gaps.
 std::vector <Range> getUntracked (
@@ -38,7 +38,9 @@ bool domGet (
   Interval& filter,
   const Rules& rules,
   const std::string& reference,
-  std::string& value)
+  std::string& value,
+  const TagExpression& expression,
+  const std::vector <std::string>& words)
 {
   Pig pig (reference);
   if (pig.skipLiteral ("dom."))
@@ -107,7 +109,7 @@ bool domGet (
     // dom.tracked.<...>
     else if (pig.skipLiteral ("tracked."))
     {
-      auto tracked = getTracked (database, rules, filter);
+      auto tracked = getTracked (database, rules, filter, expression, words);
       int count = static_cast <int> (tracked.size ());
 
       // dom.tracked.tags
@@ -149,6 +151,17 @@ bool domGet (
         return true;
       }
 
+      // dom.tracked.rollup.<tag>
+      std::string tag;
+      if (pig.skipLiteral ("rollup.") &&
+          pig.getRemainder (tag))
+      {
+        auto totals = rollupTags (tracked, database.tagHierarchy (), filter);
+        auto total = totals.find (tag);
+        value = Duration (total == totals.end () ? 0 : total->second).formatISO ();
+        return true;
+      }
+
       int n;
       // dom.tracked.<N>.<...>
       if (pig.getDigits (n) &&
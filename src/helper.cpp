@@ -26,6 +26,7 @@
 
 #include <cmake.h>
 #include <timew.h>
+#include <Clock.h>
 #include <shared.h>
 #include <format.h>
 #include <Datetime.h>
@@ -97,7 +98,7 @@ std::string intervalSummarize (const Rules& rules, const Interval& interval)
     {
       out << "Tracking " << tags << '\n'
           << "  Started " << interval.start.toISOLocalExtended () << '\n'
-          << "  Current " << minimalDelta (interval.start, Datetime ()) << '\n'
+          << "  Current " << minimalDelta (interval.start, Clock::now ()) << '\n'
           << "  Total   " << std::setw (19) << std::setfill (' ') << total.formatHours () << '\n';
     }
 
@@ -213,7 +214,7 @@ bool expandIntervalHint (
   }
   else if (hint == ":lastmonth")
   {
-    Datetime now;
+    const auto& now = Clock::now ();
     int y = now.year ();
     int y_prev = y;
 
@@ -236,7 +237,7 @@ bool expandIntervalHint (
   }
   else if (hint == ":lastquarter")
   {
-    Datetime now;
+    const auto& now = Clock::now ();
     int y = now.year ();
     int m = now.month ();
     int q = ((m - 1) / 3) + 1;
@@ -265,7 +266,7 @@ bool expandIntervalHint (
   }
   else if (hint == ":lastyear")
   {
-    Datetime now;
+    const auto& now = Clock::now ();
     range.start = Datetime (now.year () - 1,  1,  1);
     range.end   = Datetime (now.year (),      1,  1);
     debug (format ("Hint {1} expanded to {2} - {3}",
@@ -278,7 +279,7 @@ bool expandIntervalHint (
   {
     int wd = std::find (dayNames.begin (), dayNames.end (), hint) - dayNames.begin ();
 
-    Datetime now;
+    Datetime now = Clock::now ();
     int dow = now.dayOfWeek ();
     Datetime sd = now - (86400 * dow) + (86400 * (wd - 7 * (wd <= dow ? 0 : 1)));
     Datetime ed = sd + 86400;
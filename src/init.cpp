@@ -26,11 +26,13 @@
 
 #include <cmake.h>
 #include <timew.h>
+#include <Clock.h>
 #include <shared.h>
 #include <format.h>
 #include <commands.h>
 #include <cstring>
 #include <unistd.h>
+#include <algorithm>
 #include <iostream>
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -51,6 +53,8 @@ void initializeEntities (CLI& cli)
   // Command entities.
   cli.entity ("command", "annotate");
   cli.entity ("command", "cancel");
+  cli.entity ("command", "check");
+  cli.entity ("command", "compact");
   cli.entity ("command", "config");
   cli.entity ("command", "continue");
   cli.entity ("command", "delete");
@@ -67,13 +71,17 @@ void initializeEntities (CLI& cli)
   cli.entity ("command", "lengthen");
   cli.entity ("command", "modify");
   cli.entity ("command", "move");
+  cli.entity ("command", "purge");
   cli.entity ("command", "report");
   cli.entity ("command", "resize");
+  cli.entity ("command", "shift");
   cli.entity ("command", "shorten");
   cli.entity ("command", "show");
   cli.entity ("command", "split");
   cli.entity ("command", "start");
+  cli.entity ("command", "stats");
   cli.entity ("command", "stop");
+  cli.entity ("command", "sync");
   cli.entity ("command", "tag");
   cli.entity ("command", "tags");
   cli.entity ("command", "track");
@@ -94,9 +102,12 @@ void initializeEntities (CLI& cli)
   cli.entity ("hint", ":color");
   cli.entity ("hint", ":day");
   cli.entity ("hint", ":debug");
+  cli.entity ("hint", ":exclusions");
   cli.entity ("hint", ":fill");
   cli.entity ("hint", ":ids");
+  cli.entity ("hint", ":json");
   cli.entity ("hint", ":annotations");
+  cli.entity ("hint", ":hierarchy");
   cli.entity ("hint", ":lastmonth");
   cli.entity ("hint", ":lastquarter");
   cli.entity ("hint", ":lastweek");
@@ -150,10 +161,14 @@ void initializeDataJournalAndRules (
   enableDebugMode (rules.getBoolean ("debug"));
 
   // The $TIMEWARRIORDB environment variable overrides the default value of
-  // ~/.timewarrior‥
+  // ~/.timewarrior‥ Further databases, separated by ':', are mounted for
+  // reports.
   Directory dbLocation;
   char* override = getenv ("TIMEWARRIORDB");
-  dbLocation = Directory (override ? override : "~/.timewarrior");
+  std::string location = override ? override : "~/.timewarrior";
+  auto colon = location.find (':');
+  dbLocation = Directory (location.substr (0, colon));
+  auto mounts = colon == std::string::npos ? std::vector <std::string> {} : split (location.substr (colon + 1), ':');
 
   // If dbLocation exists, but is not readable/writable/executable, error.
   if (dbLocation.exists () &&
@@ -221,9 +236,35 @@ void initializeDataJournalAndRules (
     }
   }
 
-  journal.initialize (data._data + "/undo.data", rules.getInteger ("journal.size"));
+  // A fixed 'now', for deterministic tests and benchmarks.
+  if (rules.has ("debug.now"))
+    Clock::set (Datetime (rules.get ("debug.now")));
+
+  journal.initialize (data._data + "/undo.data",
+                      rules.getInteger ("journal.size"),
+                      rules.getInteger ("journal.coalesce"));
   // Initialize the database (no data read), but files are enumerated.
   database.initialize (data._data, journal);
+
+  database.setTagSeparator (rules.get ("tags.separator"));
+  database.setMemoryBudget (static_cast <size_t> (std::max (rules.getInteger ("data.memory"), 0)) * 1024 * 1024);
+
+  if (rules.getBoolean ("annotations.index"))
+    database.enableAnnotationIndex ();
+
+  if (rules.getBoolean ("changelog"))
+    database.enableChangeLog ();
+
+  // The mounted databases are read by reports only.
+  for (auto& mount : split (rules.get ("mounts"), ','))
+    mounts.push_back (trim (mount));
+
+  for (auto& mount : mounts)
+    if (! mount.empty ())
+      database.mount (mount);
+
+  if (rules.getBoolean ("hooks"))
+    database.enableHooks (rules.get ("temp.db"), static_cast <unsigned int> (std::max (rules.getInteger ("hooks.batch"), 1)));
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -269,6 +310,8 @@ int dispatchCommand (
     // command to fn mapping.
          if (command == "annotate")    status = CmdAnnotate      (cli, rules, database, journal            );
     else if (command == "cancel")      status = CmdCancel        (     rules, database, journal            );
+    else if (command == "check")       status = CmdCheck         (     rules, database                     );
+    else if (command == "compact")     status = CmdCompact       (cli, rules, database, journal            );
     else if (command == "config")      status = CmdConfig        (cli, rules,           journal            );
     else if (command == "continue")    status = CmdContinue      (cli, rules, database, journal            );
     else if (command == "day")         status = CmdChartDay      (cli, rules, database                     );
@@ -289,18 +332,22 @@ int dispatchCommand (
     else if (command == "modify")      status = CmdModify        (cli, rules, database, journal            );
     else if (command == "month")       status = CmdChartMonth    (cli, rules, database                     );
     else if (command == "move")        status = CmdMove          (cli, rules, database, journal            );
+    else if (command == "purge")       status = CmdPurge         (cli, rules, database                     );
     else if (command == "report")      status = CmdReport        (cli, rules, database,          extensions);
     else if (command == "resize")      status = CmdResize        (cli, rules, database, journal            );
+    else if (command == "shift")       status = CmdShift         (cli, rules, database, journal            );
     else if (command == "shorten")     status = CmdShorten       (cli, rules, database, journal            );
     else if (command == "show")        status = CmdShow          (     rules                               );
     else if (command == "split")       status = CmdSplit         (cli, rules, database, journal            );
     else if (command == "start")       status = CmdStart         (cli, rules, database, journal            );
+    else if (command == "stats")       status = CmdStats         (cli, rules, database                     );
     else if (command == "stop")        status = CmdStop          (cli, rules, database, journal            );
     else if (command == "summary")     status = CmdSummary       (cli, rules, database                     );
+    else if (command == "sync")        status = CmdSync          (cli, rules, database, journal            );
     else if (command == "tag")         status = CmdTag           (cli, rules, database, journal            );
-    else if (command == "tags")        status = CmdTags          (cli, rules, database                     );
+    else if (command == "tags")        status = CmdTags          (cli, rules, database, journal            );
     else if (command == "track")       status = CmdTrack         (cli, rules, database, journal            );
-    else if (command == "undo")        status = CmdUndo          (     rules, database, journal            );
+    else if (command == "undo")        status = CmdUndo          (cli, rules, database, journal            );
     else if (command == "untag")       status = CmdUntag         (cli, rules, database, journal            );
     else if (command == "week")        status = CmdChartWeek     (cli, rules, database                     );
     else                               status = CmdReport        (cli, rules, database,          extensions);
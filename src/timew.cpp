@@ -25,8 +25,8 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <cmake.h>
-#include <AtomicFile.h>
 #include <CLI.h>
+#include <Clock.h>
 #include <Database.h>
 #include <Rules.h>
 #include <Extensions.h>
@@ -51,6 +51,10 @@ int main (int argc, const char** argv)
 
   try
   {
+    // The time of this run, captured on first use.
+    Clock clock;
+    Clock::Scope clockScope (clock);
+
     // Timewarrior has special handling needs for times, such that a time that
     // is before the current time is not projected forwards to tomorrow. For
     // example:
@@ -97,8 +101,10 @@ int main (int argc, const char** argv)
 
     // Save any outstanding changes.
     database.commit ();
+    database.publish ();
 
-    AtomicFile::finalize_all ();
+    // Hooks run after the command, in the background.
+    database.runHooks ();
   }
 
   catch (const std::string& error)
@@ -33,6 +33,7 @@
 #include <Extensions.h>
 #include <Interval.h>
 #include <Exclusion.h>
+#include <TagExpression.h>
 #include <Palette.h>
 #include <Color.h>
 
@@ -51,8 +52,13 @@ std::vector <Range>     subtractRanges    (const std::vector <Range>&, const std
 Range                   outerRange        (const std::vector <Interval>&);
 bool                    matchesRange      (const Interval&, const Range&);
 bool                    matchesFilter     (const Interval&, const Interval&);
+bool                    matchesTags       (const Interval&, const Interval&);
+bool                    matchesFilter     (const Interval&, const Interval&, const TagExpression&);
+bool                    matchesAnnotation (Interval&, const std::vector <std::string>&);
 Interval                clip              (const Interval&, const Range&);
-std::vector <Interval>  getTracked        (Database&, const Rules&, Interval&);
+std::map <std::string, time_t> rollupTags (const std::vector <Interval>&, const TagInfoDatabase&, const Range&);
+std::vector <Interval>  getTracked        (Database&, const Rules&, Interval&, const TagExpression& = TagExpression (), const std::vector <std::string>& = {});
+std::vector <Interval>  getAllTracked     (Database&, const Rules&, Interval&, const TagExpression& = TagExpression (), const std::vector <std::string>& = {});
 std::vector <Range>     getUntracked      (Database&, const Rules&, Interval&);
 Interval                getLatestInterval (Database&);
 Range                   getFullDay        (const Datetime&);
@@ -60,6 +66,7 @@ Range                   getFullDay        (const Datetime&);
 // validate.cpp
 void autoFill (const Rules&, Database&, Interval&);
 bool validate (const CLI& cli, const Rules& rules, Database&, Interval&);
+bool startTracking (const CLI&, const Rules&, Database&, Interval&, bool);
 
 // init.cpp
 bool lightweightVersionCheck (int, const char**);
@@ -93,8 +100,11 @@ std::string quoteIfNeeded (const std::string&);
 std::string join(const std::string& glue, const std::set <std::string>& array);
 std::string joinQuotedIfNeeded(const std::string& glue, const std::set <std::string>& array);
 std::string joinQuotedIfNeeded(const std::string& glue, const std::vector <std::string>& array);
+std::string contentHash (const std::string&);
+std::string fileStamp (const std::string&);
+std::string fileStamp (int);
 
 // dom.cpp
-bool domGet (Database&, Interval&, const Rules&, const std::string&, std::string&);
+bool domGet (Database&, Interval&, const Rules&, const std::string&, std::string&, const TagExpression& = TagExpression (), const std::vector <std::string>& = {});
 
 #endif
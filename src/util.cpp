@@ -26,7 +26,10 @@
 
 #include <cmake.h>
 #include <timew.h>
+#include <cstdint>
+#include <sstream>
 #include <string>
+#include <sys/stat.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 // Escape all 'c' --> '\c'.
@@ -142,3 +145,58 @@ std::string joinQuotedIfNeeded(const std::string& glue, const std::vector <std::
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+// A 64-bit FNV-1a hash of content, as 16 hex digits. It detects changed files,
+// but is no protection against deliberate tampering.
+std::string contentHash (const std::string& content)
+{
+  uint64_t hash = 14695981039346656037ULL;
+  for (auto c : content)
+  {
+    hash ^= static_cast <unsigned char> (c);
+    hash *= 1099511628211ULL;
+  }
+
+  static const char* digits = "0123456789abcdef";
+  std::string hex (16, '0');
+  for (int i = 15; i >= 0; --i)
+  {
+    hex[i] = digits[hash & 0xf];
+    hash >>= 4;
+  }
+
+  return hex;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The inode, size and modification time of a file, which change whenever it is
+// written or replaced. This tells that a file changed without reading it.
+static std::string stamp (const struct stat& s)
+{
+#ifdef __APPLE__
+  auto nanoseconds = s.st_mtimespec.tv_nsec;
+#else
+  auto nanoseconds = s.st_mtim.tv_nsec;
+#endif
+
+  std::stringstream out;
+  out << s.st_ino << ':' << s.st_size << ':' << s.st_mtime << '.' << nanoseconds;
+  return out.str ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// Empty for a missing file.
+std::string fileStamp (const std::string& path)
+{
+  struct stat s;
+  return ::stat (path.c_str (), &s) == 0 ? stamp (s) : "";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// The stamp of an open file, or empty for -1.
+std::string fileStamp (int descriptor)
+{
+  struct stat s;
+  return descriptor != -1 && ::fstat (descriptor, &s) == 0 ? stamp (s) : "";
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -25,6 +25,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <cmake.h>
+#include <Clock.h>
 #include <format.h>
 #include <timew.h>
 #include <iostream>
@@ -231,3 +232,29 @@ bool validate (
 }
 
 ////////////////////////////////////////////////////////////////////////////////
+// Start tracking the open interval, stopping the one tracked so far, as the
+// start command does. Returns whether the interval was added, which it is not
+// if its tags are already tracked.
+bool startTracking (
+  const CLI& cli,
+  const Rules& rules,
+  Database& database,
+  Interval& interval,
+  bool verbose)
+{
+  if (interval.start > Clock::now ())
+  {
+    throw std::string ("Time tracking cannot be set in the future.");
+  }
+
+  // Validation stops the open interval at the start of this one.
+  if (! validate (cli, rules, database, interval))
+  {
+    return false;
+  }
+
+  database.addInterval (interval, verbose);
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
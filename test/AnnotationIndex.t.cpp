@@ -0,0 +1,95 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <test.h>
+#include <AnnotationIndex.h>
+#include <shared.h>
+
+////////////////////////////////////////////////////////////////////////////////
+static std::string positions (const std::vector <unsigned int>& lines)
+{
+  std::vector <std::string> items;
+  for (auto& line : lines)
+  {
+    items.push_back (std::to_string (line));
+  }
+
+  return join (",", items);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (19);
+
+  t.is (join (" ", AnnotationIndex::tokenize ("Fixed ABC-123, see (v1.2)")),
+        "abc-123 fixed see v1.2",
+        "tokenize: lower case, without surrounding punctuation");
+  t.is (join (" ", AnnotationIndex::tokenize ("a A a")), "a", "tokenize: words are unique");
+  t.is (AnnotationIndex::tokenize (" ... ").size (), (size_t) 0, "tokenize: punctuation only has no words");
+
+  std::vector <std::string> lines {
+    "inc 20210101T080000Z - 20210101T090000Z # foo # \"review ABC-123\"",
+    "inc 20210102T080000Z - 20210102T090000Z # foo",
+    "inc 20210103T080000Z - 20210103T090000Z # # \"abc-123 merged\"",
+  };
+
+  AnnotationIndex index;
+  index.index ("2021-01.data", lines, "c1");
+
+  t.is ((int) index.lines ("2021-01.data"), 3, "index: all lines are counted");
+  t.ok (index.is_modified (), "index: indexing modifies the index");
+  t.is (positions (index.find ("2021-01.data", {"abc-123"})), "0,2", "find: all lines with a word");
+  t.is (positions (index.find ("2021-01.data", {"abc-123", "merged"})), "2", "find: lines with all words");
+  t.is (positions (index.find ("2021-01.data", {"missing"})), "", "find: unknown word has no lines");
+  t.is (positions (index.find ("2021-02.data", {"abc-123"})), "", "find: unknown month has no lines");
+
+  t.ok (index.fresh ("2021-01.data", "c1"), "fresh: unchanged checksum");
+  t.notok (index.fresh ("2021-01.data", "c2"), "fresh: changed checksum");
+
+  t.is (index.toJson (),
+        "{\n  \"2021-01.data\":{\"checksum\":\"c1\",\"lines\":3,"
+        "\"words\":{\"abc-123\":[0,2],\"merged\":[2],\"review\":[0]}}\n}",
+        "toJson: postings per month");
+
+  index.insert ("2021-01.data", 1, "Merged ABC-123");
+  t.is ((int) index.lines ("2021-01.data"), 4, "insert: the line is counted");
+  t.is (positions (index.find ("2021-01.data", {"abc-123"})), "0,1,3", "insert: later lines move down");
+  t.is (positions (index.find ("2021-01.data", {"merged"})), "1,3", "insert: words of the line are found");
+
+  index.erase ("2021-01.data", 0);
+  t.is ((int) index.lines ("2021-01.data"), 3, "erase: the line is not counted");
+  t.is (positions (index.find ("2021-01.data", {"abc-123"})), "0,2", "erase: later lines move up");
+  t.is (positions (index.find ("2021-01.data", {"review"})), "", "erase: words only on the line are gone");
+
+  index.written ("2021-01.data", "c2");
+  t.ok (index.fresh ("2021-01.data", "c2"), "written: the checksum of the file as written");
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -390,12 +390,79 @@ int test (UnitTest& t)
   return 0;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+int wal_test (UnitTest& t)
+{
+  TempDir tempDir;
+  std::string contents;
+
+  File::write ("append.txt", "1\n2\n");
+  File::write ("remove.txt", "1\n");
+  File::write ("commit.wal",
+               "timew-wal 1\n"
+               "write 0 2 write.txt\n1\n"
+               "write 2 2 append.txt\n3\n"
+               "remove 0 0 remove.txt\n"
+               "end\n");
+
+  t.ok (AtomicFile::replay_wal ("commit.wal"), "AtomicFile::replay_wal replays a complete log");
+  File::read ("write.txt", contents);
+  t.is (contents, "1\n", "AtomicFile::replay_wal writes files");
+  File::read ("append.txt", contents);
+  t.is (contents, "1\n3\n", "AtomicFile::replay_wal rewrites files from an offset");
+  t.notok (File ("remove.txt").exists (), "AtomicFile::replay_wal removes files");
+  t.notok (File ("commit.wal").exists (), "AtomicFile::replay_wal removes the log");
+
+  tempDir.clear ();
+  File::write ("write.txt", "1\n");
+  File::write ("commit.wal", "timew-wal 1\nwrite 0 2 write.txt\n2\n");
+  t.notok (AtomicFile::replay_wal ("commit.wal"), "AtomicFile::replay_wal discards an incomplete log");
+  File::read ("write.txt", contents);
+  t.is (contents, "1\n", "AtomicFile::replay_wal leaves files of an incomplete log alone");
+
+  tempDir.clear ();
+  File::write ("append.txt", "1\n");
+  File::write ("commit.wal",
+               "timew-wal 1\n"
+               "write 0 2 write.txt\n1\n"
+               "write 4 2 append.txt\n3\n"
+               "end\n");
+  try
+  {
+    AtomicFile::replay_wal ("commit.wal");
+    t.fail ("AtomicFile::replay_wal rejects a file shorter than its offset");
+  }
+  catch (const std::string&)
+  {
+    t.pass ("AtomicFile::replay_wal rejects a file shorter than its offset");
+  }
+  t.notok (File ("write.txt").exists (), "AtomicFile::replay_wal applies no record of a rejected log");
+  t.ok (File ("commit.wal").exists (), "AtomicFile::replay_wal keeps a rejected log");
+
+  tempDir.clear ();
+  File::write ("append.txt", "1\n");
+  {
+    AtomicFile append (Path ("append.txt"));
+    append.append ("2\n");
+    AtomicFile write (Path ("write.txt"));
+    write.write_raw ("3\n");
+  }
+  AtomicFile::finalize_all ("commit.wal");
+  File::read ("append.txt", contents);
+  t.is (contents, "1\n2\n", "AtomicFile::finalize_all with a log appends");
+  t.notok (File ("commit.wal").exists (), "AtomicFile::finalize_all removes the log");
+
+  return 0;
+}
+
 int main (int, char**)
 {
-  UnitTest t (22);
+  UnitTest t (34);
   try
   {
     int ret = test (t);
+    if (ret == 0)
+      ret = wal_test (t);
     int fiu_ret = fiu_test (t);
     return (ret == 0) ? fiu_ret : ret;
   }
@@ -25,14 +25,19 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <test.h>
+#include <BatchReader.h>
 #include <Datafile.h>
 #include <Interval.h>
+#include <IntervalFactory.h>
+#include <AtomicFile.h>
+#include <timew.h>
 
 #include <TempDir.h>
+#include <cstdio>
 
 int main ()
 {
-  UnitTest t (2);
+  UnitTest t (20);
   TempDir tempDir;
 
   try
@@ -53,6 +58,101 @@ int main ()
     message = "Datafile::deleteInterval does not throw on success";
     try { df.deleteInterval (interval); t.pass (message); }
     catch (...) { t.fail (message); }
+
+    File::write ("2020-07.data", "inc 20200701T010000Z - 20200701T020000Z # foo\ninc 20200702T010000Z - 20200702T020000Z\n");
+    File::write ("2020-08.data", "inc 20200801T010000Z - 20200801T020000Z");
+
+    BatchReader reader;
+    reader.add ("2020-07.data");
+    reader.add ("2020-08.data");
+    reader.add ("2020-09.data");
+
+    std::vector <std::string> contents (3);
+    reader.read ([&] (size_t i, const std::string& content) { contents[i] = content; });
+    t.is (contents[1], "inc 20200801T010000Z - 20200801T020000Z", "BatchReader::read reads every file");
+    t.is (contents[2], "",                                         "BatchReader::read gives a missing file no contents");
+
+    Datafile read;
+    read.initialize ("2020-07.data");
+    Datafile loaded;
+    loaded.initialize ("2020-07.data");
+    loaded.load (contents[0], fileStamp ("2020-07.data"));
+    t.ok (loaded.loaded (),                                        "Datafile::load loads the lines");
+    t.ok (loaded.allLines () == read.allLines (),                  "Datafile::load splits lines as they are read");
+
+    Datafile unterminated;
+    unterminated.initialize ("2020-08.data");
+    unterminated.load (contents[1], fileStamp ("2020-08.data"));
+    t.is ((int) unterminated.allLines ().size (), 1,               "Datafile::load keeps an unterminated last line");
+
+    Datafile empty;
+    empty.initialize ("2020-09.data");
+    empty.load (contents[2], fileStamp ("2020-09.data"));
+    t.is ((int) empty.allLines ().size (), 0,                      "Datafile::load of no contents has no lines");
+
+    auto lines = read.allLines ();
+    t.ok (read.release (),                                         "Datafile::release releases a loaded file");
+    t.is ((int) read.memory (), 0,                                 "Datafile::release frees the lines");
+    t.ok (read.allLines () == lines,                               "Datafile::allLines reads a released file again");
+
+    df.addInterval (interval);
+    t.notok (df.release (),                                        "Datafile::release keeps a changed file");
+
+    Datafile pinned;
+    pinned.initialize ("2020-08.data");
+    t.ok (pinned.pin (),                                           "Datafile::pin opens the file");
+    File::write ("2020-08.tmp", "inc 20200802T010000Z - 20200802T020000Z\ninc 20200803T010000Z - 20200803T020000Z\n");
+    ::rename ("2020-08.tmp", "2020-08.data");
+    t.is ((int) pinned.allLines ().size (), 1,                     "Datafile::pin reads the file as it was when pinned");
+
+    File::write ("2020-10.data", "inc 20201001T010000Z - 20201001T020000Z\ninc 20201002T010000Z - 20201002T020000Z\n");
+    Datafile tail;
+    tail.initialize ("2020-10.data");
+    tail.deleteInterval (IntervalFactory::fromSerialization ("inc 20201002T010000Z - 20201002T020000Z"));
+    tail.addInterval (IntervalFactory::fromSerialization ("inc 20201002T010000Z - 20201002T030000Z"));
+    tail.commit ();
+    AtomicFile::finalize_all ();
+    std::string written;
+    File::read ("2020-10.data", written);
+    t.is (written, "inc 20201001T010000Z - 20201001T020000Z\ninc 20201002T010000Z - 20201002T030000Z\n",
+                                                                   "Datafile::commit replaces the changed lines at the end");
+
+    Datafile head;
+    head.initialize ("2020-10.data");
+    head.addInterval (IntervalFactory::fromSerialization ("inc 20201001T000000Z - 20201001T003000Z"));
+    head.commit ();
+    AtomicFile::finalize_all ();
+    File::read ("2020-10.data", written);
+    t.is (written, "inc 20201001T000000Z - 20201001T003000Z\ninc 20201001T010000Z - 20201001T020000Z\ninc 20201002T010000Z - 20201002T030000Z\n",
+                                                                   "Datafile::commit sorts a line added before the unchanged ones");
+
+    File::write ("2020-11.data", "inc 20201101T010000Z - 20201101T020000Z\ninc 20201102T010000Z - 20201102T020000Z\n");
+    Datafile stale;
+    stale.initialize ("2020-11.data");
+    stale.allLines ();
+    File::write ("2020-11.data", "inc 20201031T010000Z - 20201031T020000Z\ninc 20201101T010000Z - 20201101T020000Z\ninc 20201102T010000Z - 20201102T020000Z\n");
+    stale.deleteInterval (IntervalFactory::fromSerialization ("inc 20201102T010000Z - 20201102T020000Z"));
+    stale.addInterval (IntervalFactory::fromSerialization ("inc 20201102T010000Z - 20201102T030000Z"));
+    message = "Datafile::commit refuses a file changed since it was read";
+    try { stale.commit (); t.fail (message); }
+    catch (const std::string&) { t.pass (message); }
+    File::read ("2020-11.data", written);
+    t.is (written, "inc 20201031T010000Z - 20201031T020000Z\ninc 20201101T010000Z - 20201101T020000Z\ninc 20201102T010000Z - 20201102T020000Z\n",
+                                                                   "Datafile::commit keeps the changes of the other process");
+
+    File::write ("2020-12.data", "inc 20201201T010000Z - 20201201T020000Z\n");
+    Datafile late;
+    late.initialize ("2020-12.data");
+    late.addInterval (IntervalFactory::fromSerialization ("inc 20201202T010000Z - 20201202T020000Z"));
+    late.commit ();
+    File::write ("2020-12.data", "inc 20201201T010000Z - 20201201T030000Z # foo\n");
+    message = "AtomicFile::finalize_all refuses a file changed after commit";
+    try { AtomicFile::finalize_all (); t.fail (message); }
+    catch (const std::string&) { t.pass (message); }
+    AtomicFile::reset ();
+    File::read ("2020-12.data", written);
+    t.is (written, "inc 20201201T010000Z - 20201201T030000Z # foo\n",
+                                                                   "AtomicFile::finalize_all keeps the changes of the other process");
   }
   catch (...)
   {
@@ -0,0 +1,142 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <test.h>
+#include <DayBitmap.h>
+#include <timew.h>
+#include <algorithm>
+#include <random>
+#include <sstream>
+
+////////////////////////////////////////////////////////////////////////////////
+// The Range based subtraction, which the bitmap must agree with.
+static std::vector <Range> subtractReference (
+  const std::vector <Range>& ranges,
+  const std::vector <Range>& subtractions)
+{
+  std::vector <Range> results = ranges;
+  for (auto& s : subtractions)
+  {
+    std::vector <Range> split_results;
+    for (auto& range : results)
+      for (auto& split_range : range.subtract (s))
+        split_results.push_back (split_range);
+
+    results = split_results;
+  }
+
+  return results;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+static std::string describe (const std::vector <Range>& ranges)
+{
+  std::stringstream out;
+  for (auto& range : ranges)
+    out << '[' << range.start.toEpoch () << ',' << range.end.toEpoch () << ')';
+
+  return out.str ();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  const int trials = 200;
+  UnitTest t (9 + trials);
+
+  DayBitmap bitmap (Datetime (2021, 6, 15, 12, 0, 0));
+  auto day = bitmap.day ();
+  auto start = day.start.toEpoch ();
+
+  t.ok (day.start == Datetime (2021, 6, 15), "day: starts at midnight");
+  t.ok (bitmap.empty (), "empty: new bitmap");
+
+  bitmap.set (Range (Datetime (start + 10), Datetime (start + 100)));
+  bitmap.set (Range (Datetime (start + 90), Datetime (start + 200)));
+  t.is ((int) bitmap.count (), 190, "count: overlapping ranges are counted once");
+  t.is (describe (bitmap.ranges ()), describe ({Range (Datetime (start + 10), Datetime (start + 200))}), "ranges: overlapping ranges become one");
+
+  bitmap.clear (Range (Datetime (start + 64), Datetime (start + 128)));
+  t.is (describe (bitmap.ranges ()),
+        describe ({Range (Datetime (start + 10), Datetime (start + 64)),
+                   Range (Datetime (start + 128), Datetime (start + 200))}),
+        "ranges: cleared whole word splits the range");
+
+  DayBitmap open (day.start);
+  open.set (Range (Datetime (start - 3600), Datetime (0)));
+  t.is (describe (open.ranges ()), describe ({day}), "set: open range before the day fills the day");
+
+  open.subtract (bitmap);
+  t.is ((int) open.count (), (int) (day.total () - bitmap.count ()), "subtract: remaining seconds");
+
+  open &= bitmap;
+  t.ok (open.empty (), "and: disjoint bitmaps");
+
+  t.notok (bitmap.covers (Range (Datetime (start + 10), Datetime (0))), "covers: not an open range");
+
+  // Differential test of subtractRanges, which uses the bitmap for ranges
+  // within one day, against the Range based subtraction.
+  std::mt19937 generator (4711);
+  std::uniform_int_distribution <int> second (-7200, static_cast <int> (day.total ()) + 7200);
+  std::uniform_int_distribution <int> count (0, 6);
+
+  for (int trial = 0; trial < trials; ++trial)
+  {
+    std::vector <int> cuts;
+    int ranges = count (generator);
+    for (int i = 0; i < 2 * ranges; ++i)
+      cuts.push_back (std::max (0, std::min (static_cast <int> (day.total ()), second (generator))));
+
+    std::sort (cuts.begin (), cuts.end ());
+    cuts.erase (std::unique (cuts.begin (), cuts.end ()), cuts.end ());
+
+    std::vector <Range> input;
+    for (unsigned int i = 0; i + 1 < cuts.size (); i += 2)
+      input.push_back (Range (Datetime (start + cuts[i]), Datetime (start + cuts[i + 1])));
+
+    std::vector <Range> subtractions;
+    int n = count (generator);
+    for (int i = 0; i < n; ++i)
+    {
+      auto from = second (generator);
+      auto to = second (generator);
+      if (from > to)
+        std::swap (from, to);
+
+      // Some subtractions are open.
+      subtractions.push_back (Range (Datetime (start + from), Datetime (to % 5 ? start + to : 0)));
+    }
+
+    auto expected = subtractReference (input, subtractions);
+    auto actual   = subtractRanges (input, subtractions);
+    t.is (describe (actual), describe (expected), "subtractRanges: trial " + std::to_string (trial) + " " + describe (input));
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
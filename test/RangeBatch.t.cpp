@@ -0,0 +1,96 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <test.h>
+#include <RangeBatch.h>
+#include <algorithm>
+#include <random>
+
+////////////////////////////////////////////////////////////////////////////////
+// Random ranges around a fixed time, some open, some not started, some empty.
+static Range randomRange (std::mt19937& generator)
+{
+  std::uniform_int_distribution <int> offset (0, 20);
+  std::uniform_int_distribution <int> kind (0, 9);
+
+  time_t base = 1600000000;
+  time_t start = base + offset (generator);
+  time_t end = start + offset (generator) - 3;
+
+  switch (kind (generator))
+  {
+  case 0:  return Range (Datetime (start), Datetime (0));
+  case 1:  return Range (Datetime (0), Datetime (end));
+  case 2:  return Range (Datetime (start), Datetime (start));
+  default: return Range (Datetime (start), Datetime (std::max (start, end)));
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  const int trials = 100;
+  UnitTest t (3 + 2 * trials);
+
+  RangeBatch empty;
+  t.is ((int) empty.intersecting (Range (Datetime (1600000000), Datetime (0))).size (), 0, "intersecting: empty batch");
+
+  RangeBatch batch ({Range (Datetime (1600000000), Datetime (1600000010)),
+                     Range (Datetime (1600000020), Datetime (0))});
+  t.is ((int) batch.intersecting (Range (Datetime (1600000005), Datetime (1600000025))).size (), 2, "intersecting: both");
+  t.is ((int) batch.intersecting (Range (Datetime (0), Datetime (1600000025))).size (), 0, "intersecting: filter not started");
+
+  // Differential test against the Range methods.
+  std::mt19937 generator (4711);
+  for (int trial = 0; trial < trials; ++trial)
+  {
+    std::vector <Range> ranges;
+    for (int i = 0; i < 50; ++i)
+      ranges.push_back (randomRange (generator));
+
+    RangeBatch batch (ranges);
+    auto other = randomRange (generator);
+
+    std::vector <unsigned int> intersecting;
+    std::vector <unsigned int> enclosed;
+    for (unsigned int i = 0; i < ranges.size (); ++i)
+    {
+      if (other.intersects (ranges[i]))
+        intersecting.push_back (i);
+
+      if (other.encloses (ranges[i]))
+        enclosed.push_back (i);
+    }
+
+    t.ok (batch.intersecting (other) == intersecting, "intersecting: trial " + std::to_string (trial));
+    t.ok (batch.enclosedBy (other) == enclosed, "enclosedBy: trial " + std::to_string (trial));
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,94 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef TIMEW_SCRATCH_DIR
+#define TIMEW_SCRATCH_DIR
+
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <string>
+
+// A temporary working directory for the API tests, which link only the shared
+// library and so cannot use TempDir, as it depends on libshared.
+class ScratchDir
+{
+public:
+  ScratchDir ();
+  ~ScratchDir ();
+
+private:
+  static int removeEntry (const char*, const struct stat*, int, struct FTW*);
+
+  std::string tmpName {};
+  std::string oldDir {};
+};
+
+////////////////////////////////////////////////////////////////////////////////
+ScratchDir::ScratchDir ()
+{
+  char cwd[4096];
+  if (::getcwd (cwd, sizeof (cwd)) == nullptr)
+  {
+    throw std::string ("Failed to read the current directory");
+  }
+
+  oldDir = cwd;
+
+  char template_name[] = "scratch_XXXXXX";
+  if (::mkdtemp (template_name) == nullptr)
+  {
+    throw std::string ("Failed to create temp directory");
+  }
+
+  tmpName = oldDir + '/' + template_name;
+
+  if (::chdir (tmpName.c_str ()))
+  {
+    throw std::string ("Failed to change to temporary directory");
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+ScratchDir::~ScratchDir ()
+{
+  if (::chdir (oldDir.c_str ()) ||
+      ::nftw (tmpName.c_str (), removeEntry, 16, FTW_DEPTH | FTW_PHYS))
+  {
+    std::cerr << "Failed to remove temp dir " << tmpName << '\n';
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int ScratchDir::removeEntry (const char* path, const struct stat*, int, struct FTW*)
+{
+  return ::remove (path);
+}
+
+#endif // TIMEW_SCRATCH_DIR
@@ -0,0 +1,118 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <test.h>
+#include <api/Session.h>
+
+#include <ScratchDir.h>
+
+////////////////////////////////////////////////////////////////////////////////
+int main ()
+{
+  UnitTest t (23);
+  ScratchDir scratchDir;
+
+  // 2020-01-01T09:00:00Z to 2020-01-01T10:00:00Z.
+  const time_t start = 1577869200;
+  const time_t end   = 1577872800;
+
+  try
+  {
+    {
+      timew::Session session;
+
+      try { session.open ("db"); t.fail ("Session::open throws without a database"); }
+      catch (const timew::Error&) { t.pass ("Session::open throws without a database"); }
+      t.notok (session.isOpen (), "Session::isOpen false after a failed open");
+
+      session.open ("db", true);
+      t.ok (session.isOpen (), "Session::open creates a database");
+
+      session.track (start, end, {"foo", "bar"}, "some notes");
+      t.ok (session.modified (), "Session::modified after track");
+      session.commit ();
+      t.notok (session.modified (), "Session::modified not after commit");
+
+      try { session.track (start, end, {"baz"}); t.fail ("Session::track throws on overlap"); }
+      catch (const timew::Error&) { t.pass ("Session::track throws on overlap"); }
+
+      session.start ({"baz"}, end + 3600);
+      auto active = session.active ();
+      t.is (active.id, 1,                         "Session::active id is @1");
+      t.ok (active.end == 0,                      "Session::active is open");
+
+      session.start ({"qux"}, end + 5400);
+      active = session.active ();
+      t.ok (active.tags == std::vector <std::string> {"qux"}, "Session::start replaces the open interval");
+      t.is ((int) session.query ().size (), 3,    "Session::start stops the open interval");
+
+      session.stop (end + 7200);
+      t.is (session.active ().id, 0,              "Session::active id is 0 after stop");
+      session.commit ();
+    }
+
+    {
+      timew::Session session;
+      session.open ("db");
+
+      auto intervals = session.query ();
+      t.is ((int) intervals.size (), 3,           "Session::query finds all intervals after reopen");
+
+      timew::Query query;
+      query.tags = {"foo"};
+      intervals = session.query (query);
+      t.is ((int) intervals.size (), 1,           "Session::query by tag finds one interval");
+      t.is (intervals[0].id, 3,                   "Session::query id is @3");
+      t.ok (intervals[0].start == start,          "Session::query start");
+      t.ok (intervals[0].end == end,              "Session::query end");
+      t.is ((int) intervals[0].tags.size (), 2,   "Session::query has both tags");
+      t.is (intervals[0].annotation, "some notes", "Session::query annotation");
+
+      query = timew::Query ();
+      query.start = end;
+      t.is ((int) session.query (query).size (), 2, "Session::query by range finds the later intervals");
+
+      timew::Session other;
+      other.open ("db");
+      other.track (end + 10800, end + 14400, {"zap"});
+      t.is ((int) session.query ().size (), 3,    "Session::query does not see the changes of another Session");
+      t.notok (session.modified (),               "Session::modified not after a change by another Session");
+
+      other.commit ();
+      t.is ((int) session.query ().size (), 4,    "Session::query sees the changes committed by another Session");
+      t.is (session.active ().id, 0,              "Session::active id is 0 after the other Session commits");
+    }
+  }
+
+  catch (const std::exception& error)
+  {
+    t.fail (error.what ());
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
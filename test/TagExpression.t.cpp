@@ -0,0 +1,120 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <cmake.h>
+#include <test.h>
+#include <TagExpression.h>
+
+////////////////////////////////////////////////////////////////////////////////
+static Interval tagged (const std::vector <std::string>& tags)
+{
+  Interval interval;
+  for (auto& tag : tags)
+  {
+    interval.tag (tag);
+  }
+
+  return interval;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+int main (int, char**)
+{
+  UnitTest t (19);
+
+  auto a          = tagged ({"CLIENT_A"});
+  auto b_internal = tagged ({"CLIENT_B", "INTERNAL"});
+  auto c          = tagged ({"CLIENT_C"});
+  auto none       = tagged ({});
+
+  TagExpression empty;
+  t.ok (empty.empty (), "TagExpression: default is empty");
+  t.ok (empty.matches (none), "TagExpression: empty expression matches everything");
+
+  auto expression = TagExpression ("(CLIENT_A or CLIENT_B) and not INTERNAL");
+  t.ok    (expression.matches (a),          "TagExpression: (A or B) and not I matches A");
+  t.notok (expression.matches (b_internal), "TagExpression: (A or B) and not I rejects B I");
+  t.notok (expression.matches (c),          "TagExpression: (A or B) and not I rejects C");
+
+  t.ok    (expression.matchesLine ("inc 20210101T100000Z - 20210101T110000Z # \"CLIENT_A\""),
+           "TagExpression: matchesLine accepts quoted tag");
+  t.notok (expression.matchesLine ("inc 20210101T100000Z - 20210101T110000Z # \"CLIENT_B\" INTERNAL"),
+           "TagExpression: matchesLine rejects B I");
+  t.notok (expression.matchesLine ("inc 20210101T100000Z # tag # \"CLIENT_A\""),
+           "TagExpression: matchesLine does not read the annotation as tags");
+  t.ok    (expression.matchesLine ("inc 20210101T100000Z # \"a\\\"b\""),
+           "TagExpression: matchesLine leaves escaped tags to the parser");
+
+  auto implicit = TagExpression ("CLIENT_B INTERNAL");
+  t.ok    (implicit.matches (b_internal), "TagExpression: juxtaposition means 'and'");
+  t.notok (implicit.matches (a),          "TagExpression: juxtaposition rejects partial match");
+
+  auto other = TagExpression ("not CLIENT_C");
+  t.notok (other.matches (c), "TagExpression: not C rejects C");
+  t.ok    (other.matches (a), "TagExpression: not C matches A");
+
+  auto quoted = TagExpression ("'or'");
+  t.ok (quoted.matches (tagged ({"or"})), "TagExpression: quoted operator is a tag");
+
+  TagExpression combined ("CLIENT_A or CLIENT_B");
+  combined.conjoin (TagExpression ("not INTERNAL"));
+  t.ok    (combined.matches (a),          "TagExpression: conjunction matches A");
+  t.notok (combined.matches (b_internal), "TagExpression: conjunction rejects B I");
+
+  try
+  {
+    TagExpression ("(CLIENT_A or CLIENT_B");
+    t.fail ("TagExpression: missing ')' throws");
+  }
+  catch (const std::string&)
+  {
+    t.pass ("TagExpression: missing ')' throws");
+  }
+
+  try
+  {
+    TagExpression ("CLIENT_A or");
+    t.fail ("TagExpression: incomplete expression throws");
+  }
+  catch (const std::string&)
+  {
+    t.pass ("TagExpression: incomplete expression throws");
+  }
+
+  try
+  {
+    TagExpression ("CLIENT_A )");
+    t.fail ("TagExpression: unbalanced ')' throws");
+  }
+  catch (const std::string&)
+  {
+    t.pass ("TagExpression: unbalanced ')' throws");
+  }
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
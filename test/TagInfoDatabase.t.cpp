@@ -27,11 +27,13 @@
 #include <cmake.h>
 #include <test.h>
 #include <TagInfoDatabase.h>
+#include <shared.h>
+#include <timew.h>
 
 ////////////////////////////////////////////////////////////////////////////////
 int main (int, char**)
 {
-  UnitTest t (8);
+  UnitTest t (14);
 
   {
     TagInfoDatabase tagInfoDatabase{};
@@ -85,6 +87,24 @@ int main (int, char**)
     }
   }
 
+  {
+    TagInfoDatabase tagInfoDatabase{};
+
+    tagInfoDatabase.add ("acme.web.api", TagInfo{1});
+    tagInfoDatabase.add ("plain", TagInfo{1});
+
+    t.ok (tagInfoDatabase.ancestors ("acme.web.api").empty (), "Without separator there are no ancestors");
+
+    tagInfoDatabase.setSeparator (".");
+    tagInfoDatabase.add ("acme.app", TagInfo{1});
+
+    t.is (join (",", tagInfoDatabase.ancestors ("acme.web.api")), "acme,acme.web", "Ancestors are listed outermost first");
+    t.is (join (",", tagInfoDatabase.ancestors ("acme.web")), "acme", "Ancestors of an ancestor are known");
+    t.is (join (",", tagInfoDatabase.children ("acme")), "acme.app,acme.web", "Children of an ancestor");
+    t.is (join (",", tagInfoDatabase.children ("acme.web")), "acme.web.api", "Children of an inner ancestor");
+    t.ok (tagInfoDatabase.ancestors ("plain").empty (), "Tag without separator has no ancestors");
+  }
+
   return 0;
 }
 
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+
+###############################################################################
+#
+# Copyright 2016 - 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# https://www.opensource.org/licenses/mit-license.php
+#
+###############################################################################
+
+import os
+import sys
+import unittest
+
+from datetime import datetime, timedelta
+
+# Ensure python finds the local simpletap module
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from basetest import Timew, TestCase
+
+
+
+
+class TestCheck(TestCase):
+    def setUp(self):
+        """Executed before each test in the class"""
+        self.t = Timew()
+
+    def datafile(self, name):
+        return os.path.join(self.t.datadir, "data", name)
+
+    def test_check_of_unchanged_database(self):
+        """Check reports nothing for files written by Timewarrior"""
+        self.t("track FOO 2021-01-01T08:00:00Z - 2021-01-01T09:00:00Z")
+        self.t("track FOO 2021-02-01T08:00:00Z - 2021-02-01T09:00:00Z")
+
+        code, out, err = self.t("check")
+
+        self.assertIn("Checked 2 data files, 0 edited outside of Timewarrior.", out)
+        self.assertTrue(os.path.exists(self.datafile("checksums.data")))
+
+    def test_reports_do_not_write_checksums(self):
+        """Commands that only read do not record checksums"""
+        self.t("track FOO 2021-02-01T08:00:00Z - 2021-02-01T09:00:00Z")
+        os.remove(self.datafile("checksums.data"))
+
+        self.t("export")
+
+        self.assertFalse(os.path.exists(self.datafile("checksums.data")))
+
+    def test_reports_count_tags_of_edited_files(self):
+        """Reports recount the tags when a data file was edited outside of Timewarrior"""
+        self.t("track acme.web 2021-02-01T08:00:00 - 2021-02-01T09:00:00")
+
+        path = self.datafile("2021-02.data")
+        with open(path) as f:
+            contents = f.read()
+        with open(path, "w") as f:
+            f.write(contents.replace("acme.web", "acme.api"))
+
+        code, out, err = self.t("summary 2021-02-01 - 2021-02-02 :hierarchy")
+
+        self.assertRegex(out, "\nacme +1:00:00\n"
+                              "  acme.api +1:00:00\n")
+
+    def test_check_reports_broken_lines(self):
+        """Check reports the lines of an edited file that are not intervals"""
+        self.t("track FOO 2021-02-01T08:00:00Z - 2021-02-01T09:00:00Z")
+
+        with open(self.datafile("2021-02.data"), "a") as f:
+            f.write("garbage\n")
+
+        code, out, err = self.t.runError("check")
+
+        self.assertEqual(code, 1)
+        self.assertIn("2021-02.data line 2:", out)
+
+    def test_check_accepts_valid_edits(self):
+        """Check accepts an edited file that parses, and recounts the tags"""
+        self.t("track FOO 2021-02-01T08:00:00Z - 2021-02-01T09:00:00Z")
+
+        path = self.datafile("2021-02.data")
+        with open(path) as f:
+            contents = f.read()
+        with open(path, "w") as f:
+            f.write(contents.replace("FOO", "BAR"))
+
+        code, out, err = self.t("check")
+        self.assertIn("Checked 1 data file, 1 edited outside of Timewarrior.", out)
+
+        with open(self.datafile("tags.data")) as f:
+            tags = f.read()
+        self.assertIn("BAR", tags)
+        self.assertNotIn("FOO", tags)
+
+        code, out, err = self.t("check")
+        self.assertIn("Checked 1 data file, 0 edited outside of Timewarrior.", out)
+
+
+if __name__ == "__main__":
+    from simpletap import TAPTestRunner
+
+    unittest.main(testRunner=TAPTestRunner())
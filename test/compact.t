@@ -0,0 +1,98 @@
+#!/usr/bin/env python3
+
+###############################################################################
+#
+# Copyright 2016 - 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# https://www.opensource.org/licenses/mit-license.php
+#
+###############################################################################
+
+import os
+import sys
+import unittest
+
+from datetime import datetime, timedelta
+
+# Ensure python finds the local simpletap module
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from basetest import Timew, TestCase
+
+
+
+class TestCompact(TestCase):
+    def setUp(self):
+        """Executed before each test in the class"""
+        self.t = Timew()
+
+    def test_compact_touching_intervals(self):
+        """Compact merges touching intervals with the same tags"""
+        self.t("track 2016-01-01T10:00:00Z - 2016-01-01T11:00:00Z foo")
+        self.t("track 2016-01-01T11:00:00Z - 2016-01-01T12:00:00Z foo")
+        self.t("track 2016-01-01T12:00:00Z - 2016-01-01T13:00:00Z foo")
+        self.t("track 2016-01-01T13:00:00Z - 2016-01-01T14:00:00Z bar")
+        self.t("track 2016-01-01T15:00:00Z - 2016-01-01T16:00:00Z bar")
+
+        code, out, err = self.t("compact")
+
+        self.assertIn('Compacted 5 intervals into 3.', out)
+
+        j = self.t.export()
+
+        self.assertEqual(len(j), 3)
+        self.assertClosedInterval(j[0],
+                                  expectedStart="20160101T100000Z",
+                                  expectedEnd="20160101T130000Z",
+                                  expectedTags=["foo"])
+        self.assertClosedInterval(j[1],
+                                  expectedStart="20160101T130000Z",
+                                  expectedEnd="20160101T140000Z",
+                                  expectedTags=["bar"])
+
+    def test_compact_keeps_different_annotations(self):
+        """Compact does not merge intervals with different annotations"""
+        self.t("track 2016-01-01T10:00:00Z - 2016-01-01T11:00:00Z foo")
+        self.t("track 2016-01-01T11:00:00Z - 2016-01-01T12:00:00Z foo")
+        self.t("annotate @1 lorem")
+
+        code, out, err = self.t("compact")
+
+        self.assertIn('Compacted 2 intervals into 2.', out)
+        self.assertEqual(len(self.t.export()), 2)
+
+    def test_compact_and_undo(self):
+        """Undo a compaction in one step"""
+        self.t("track 2016-01-01T10:00:00Z - 2016-01-01T11:00:00Z foo")
+        self.t("track 2016-01-01T11:00:00Z - 2016-01-01T12:00:00Z foo")
+        before = self.t.export()
+
+        self.t("compact")
+        self.assertEqual(len(self.t.export()), 1)
+
+        self.t("undo")
+        self.assertEqual(before, self.t.export())
+
+
+if __name__ == "__main__":
+    from simpletap import TAPTestRunner
+
+    unittest.main(testRunner=TAPTestRunner())
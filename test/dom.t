@@ -167,6 +167,21 @@ class TestDOMTracked(TestCase):
         code, out, err = self.t("get dom.tracked.count")
         self.assertEqual('2\n', out)
 
+    def test_dom_tracked_rollup(self):
+        """Test dom.tracked.rollup.<tag> totals a tag and its descendants"""
+        self.t("track 2017-03-09T08:00:00 - 2017-03-09T09:00:00 acme.web.api")
+        self.t("track 2017-03-09T09:00:00 - 2017-03-09T10:30:00 acme.app")
+        self.t("track 2017-03-09T11:00:00 - 2017-03-09T12:00:00 other")
+
+        code, out, err = self.t("get dom.tracked.rollup.acme")
+        self.assertEqual("PT2H30M\n", out)
+
+        code, out, err = self.t("get dom.tracked.rollup.acme.web")
+        self.assertEqual("PT1H\n", out)
+
+        code, out, err = self.t("get dom.tracked.rollup.missing")
+        self.assertEqual("PT0S\n", out)
+
     def test_dom_tracked_tags_with_emtpy_database(self):
         """Test dom.tracked.tags with empty database"""
         code, out, err = self.t("get dom.tracked.tags")
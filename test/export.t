@@ -198,6 +198,121 @@ class TestExport(TestCase):
                                   expectedId=2,
                                   expectedTags=["Tag1", "Tag3"])
 
+    def test_export_with_tag_expression(self):
+        """Export with boolean tag expression"""
+        self.t("track CLIENT_A 2017-03-09T08:00:00 - 2017-03-09T09:00:00")
+        self.t("track CLIENT_B INTERNAL 2017-03-09T09:00:00 - 2017-03-09T10:00:00")
+        self.t("track CLIENT_B 2017-03-09T10:00:00 - 2017-03-09T11:00:00")
+        self.t("track CLIENT_C 2017-03-09T11:00:00 - 2017-03-09T12:00:00")
+
+        j = self.t.export("'tags:(CLIENT_A or CLIENT_B) and not INTERNAL'")
+
+        self.assertEqual(len(j), 2)
+
+        self.assertClosedInterval(j[0],
+                                  expectedId=4,
+                                  expectedTags=["CLIENT_A"])
+        self.assertClosedInterval(j[1],
+                                  expectedId=2,
+                                  expectedTags=["CLIENT_B"])
+
+    def test_export_with_tag_expression_and_unknown_tag(self):
+        """Export with tag expression referencing an unknown tag"""
+        self.t("track CLIENT_A 2017-03-09T08:00:00 - 2017-03-09T09:00:00")
+
+        j = self.t.export("'tags:CLIENT_A and UNKNOWN'")
+        self.assertEqual(len(j), 0)
+
+        j = self.t.export("'tags:CLIENT_A and not UNKNOWN'")
+        self.assertEqual(len(j), 1)
+
+    def test_export_with_tag_expression_and_stale_tags_database(self):
+        """Export with tag expression matches tags missing from the tags database"""
+        self.t("track CLIENT_A 2017-03-09T08:00:00 - 2017-03-09T09:00:00")
+
+        with open(os.path.join(self.t.datadir, "data", "tags.data"), "w") as f:
+            f.write("{}")
+
+        j = self.t.export("'tags:CLIENT_A'")
+        self.assertEqual(len(j), 1)
+
+    def test_export_with_invalid_tag_expression(self):
+        """Export with invalid tag expression fails"""
+        code, out, err = self.t.runError("export 'tags:(CLIENT_A or'")
+
+        self.assertIn("expression", err)
+
+    def _track_annotated(self):
+        self.t("track FOO 2017-02-27T08:00:00 - 2017-02-27T09:00:00")
+        self.t("annotate @1 'Review ABC-123'")
+        self.t("track BAR 2017-03-09T08:00:00 - 2017-03-09T09:00:00")
+        self.t("track FOO 2017-03-09T09:00:00 - 2017-03-09T10:00:00")
+        self.t("annotate @1 'abc-123, merged'")
+
+    def test_export_with_annotation_filter(self):
+        """Export with annotation word filter"""
+        self._track_annotated()
+
+        j = self.t.export("annotation:~ABC-123")
+
+        self.assertEqual(len(j), 2)
+        self.assertClosedInterval(j[0], expectedId=3, expectedAnnotation="Review ABC-123")
+        self.assertClosedInterval(j[1], expectedId=1, expectedAnnotation="abc-123, merged")
+
+        j = self.t.export("annotation:~abc-123 annotation:~merged")
+
+        self.assertEqual(len(j), 1)
+        self.assertClosedInterval(j[0], expectedId=1)
+
+    def test_export_with_annotation_filter_and_index(self):
+        """Export with annotation word filter using the annotation index"""
+        self.t.config("annotations.index", "on")
+        self._track_annotated()
+
+        j = self.t.export("annotation:~abc-123")
+
+        self.assertEqual(len(j), 2)
+        self.assertClosedInterval(j[0], expectedId=3, expectedAnnotation="Review ABC-123")
+        self.assertClosedInterval(j[1], expectedId=1, expectedAnnotation="abc-123, merged")
+
+        self.t("annotate @3 'Reviewed'")
+
+        j = self.t.export("annotation:~abc-123")
+
+        self.assertEqual(len(j), 1)
+        self.assertClosedInterval(j[0], expectedId=1)
+
+    def test_export_with_annotation_filter_index_and_range(self):
+        """Export with annotation filter and index keeps ids when searching a range"""
+        self.t.config("annotations.index", "on")
+        self._track_annotated()
+        self.t("track QUX 2017-03-09T06:00:00 - 2017-03-09T07:00:00")
+        self.t("annotate @3 'ABC-123 again'")
+
+        j = self.t.export("annotation:~abc-123")
+
+        self.assertEqual(len(j), 3)
+        self.assertClosedInterval(j[0], expectedId=4, expectedAnnotation="Review ABC-123")
+        self.assertClosedInterval(j[1], expectedId=3, expectedAnnotation="ABC-123 again")
+        self.assertClosedInterval(j[2], expectedId=1, expectedAnnotation="abc-123, merged")
+
+        j = self.t.export("2017-02-01 - 2017-03-01 annotation:~abc-123")
+
+        self.assertEqual(len(j), 1)
+        self.assertClosedInterval(j[0], expectedId=4, expectedAnnotation="Review ABC-123")
+
+    def test_export_with_annotation_filter_and_index_of_open_interval(self):
+        """Export with annotation index keeps ids when the latest interval is open"""
+        self.t.config("annotations.index", "on")
+        self.t("track FOO 2017-03-09T08:00:00 - 2017-03-09T09:00:00")
+        self.t("annotate @1 'ABC-123'")
+        self.t("start BAR 2017-03-09T10:00:00")
+
+        j = self.t.export("annotation:~abc-123")
+
+        self.assertEqual(len(j), 1)
+        self.assertClosedInterval(j[0], expectedId=2, expectedAnnotation="ABC-123")
+
     def test_export_with_intersecting_filter(self):
         """Export with filter that is contained by interval"""
         self.t("track Tag1 2021-02-01T00:00:00 - 2021-03-01T00:00:00")
@@ -213,6 +328,59 @@ class TestExport(TestCase):
                                   expectedId=2,
                                   expectedTags=["Tag1"])
 
+    def test_export_changes_since_cursor(self):
+        """Export the changes after a sequence number"""
+        self.t.config("changelog", "on")
+        self.t("track FOO 2021-02-01T08:00:00 - 2021-02-01T09:00:00")
+        self.t("track BAR 2021-02-01T10:00:00 - 2021-02-01T11:00:00")
+        self.t("tag @1 BAZ")
+
+        j = self.t.export("since:0")
+
+        self.assertEqual([change["seq"] for change in j], [1, 2, 3, 4])
+        self.assertIsNone(j[0]["before"])
+        self.assertClosedInterval(j[0]["after"], expectedTags=["FOO"])
+        self.assertClosedInterval(j[2]["before"], expectedTags=["BAR"])
+        self.assertIsNone(j[2]["after"])
+        self.assertIsNone(j[3]["before"])
+        self.assertClosedInterval(j[3]["after"], expectedTags=["BAR", "BAZ"])
+
+        j = self.t.export("since:2")
+
+        self.assertEqual([change["seq"] for change in j], [3, 4])
+
+        j = self.t.export("since:4")
+
+        self.assertEqual(len(j), 0)
+
+    def test_export_changes_logs_undo_and_is_not_trimmed(self):
+        """Undone changes are logged as further changes, whatever the journal size"""
+        self.t.config("changelog", "on")
+        self.t.config("journal.size", "1")
+        self.t("track FOO 2021-02-01T08:00:00 - 2021-02-01T09:00:00")
+        self.t("track BAR 2021-02-01T10:00:00 - 2021-02-01T11:00:00")
+        self.t("undo")
+
+        j = self.t.export("since:0")
+
+        self.assertEqual([change["seq"] for change in j], [1, 2, 3])
+        self.assertClosedInterval(j[2]["before"], expectedTags=["BAR"])
+        self.assertIsNone(j[2]["after"])
+
+    def test_export_changes_without_changelog(self):
+        """Export of changes fails when the change log is not enabled"""
+        code, out, err = self.t.runError("export since:0")
+
+        self.assertIn("The change log is not enabled.", err)
+
+    def test_export_changes_with_invalid_cursor(self):
+        """Export of changes fails with an invalid sequence number"""
+        self.t.config("changelog", "on")
+
+        code, out, err = self.t.runError("export since:abc")
+
+        self.assertIn("'abc' is not a valid sequence number.", err)
+
 
 if __name__ == "__main__":
     from simpletap import TAPTestRunner
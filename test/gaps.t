@@ -64,6 +64,14 @@ class TestGaps(TestCase):
         code, out, err = self.t("gaps 2016-05-27 - 2016-05-28")
         self.assertRegex(out, r'\s{30}5:00:00')
 
+    def test_gaps_of_the_day_of_a_fixed_clock(self):
+        """Without a range, gaps are those of the day of the current time"""
+        self.t.config("debug.now", "2016-05-27T23:00:00")
+        self.t("track 20160527T080000 - 20160527T200000 foo")
+
+        code, out, err = self.t("gaps")
+        self.assertRegex(out, r'\s{30}12:00:00')
+
 
 if __name__ == "__main__":
     from simpletap import TAPTestRunner
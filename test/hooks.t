@@ -0,0 +1,167 @@
+#!/usr/bin/env python3
+
+###############################################################################
+#
+# Copyright 2016 - 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# https://www.opensource.org/licenses/mit-license.php
+#
+###############################################################################
+
+import json
+import os
+import stat
+import sys
+import time
+import unittest
+
+# Ensure python finds the local simpletap module
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from basetest import Timew, TestCase
+
+
+class TestHooks(TestCase):
+    def setUp(self):
+        """Executed before each test in the class"""
+        self.t = Timew()
+        self.t.config("hooks", "on")
+        self.hooks = os.path.join(self.t.datadir, "hooks")
+        self.log = os.path.join(self.t.datadir, "hooks.log")
+        os.mkdir(self.hooks)
+
+    def add_hook(self, name, status=0):
+        path = os.path.join(self.hooks, name)
+        with open(path, "w") as f:
+            f.write("#!/bin/sh\ncat >> '{}'\nexit {}\n".format(self.log, status))
+        os.chmod(path, stat.S_IRWXU)
+
+    def wait_for_log(self, lines):
+        for _ in range(100):
+            if os.path.exists(self.log):
+                with open(self.log) as f:
+                    content = f.read().splitlines()
+                if len(content) >= lines:
+                    return [json.loads(line) for line in content]
+            time.sleep(0.1)
+        self.fail("Hooks did not run")
+
+    def test_hook_receives_committed_changes(self):
+        """Hooks receive the changes of a command after it returns"""
+        self.add_hook("on-commit-log")
+
+        self.t("track FOO 2021-02-01T08:00:00Z - 2021-02-01T09:00:00Z")
+
+        log = self.wait_for_log(1)
+        self.assertEqual(len(log), 1)
+        self.assertEqual(len(log[0]["changes"]), 1)
+        self.assertIsNone(log[0]["changes"][0]["before"])
+        self.assertClosedInterval(log[0]["changes"][0]["after"],
+                                  expectedStart="20210201T080000Z",
+                                  expectedEnd="20210201T090000Z",
+                                  expectedTags=["FOO"])
+
+    def test_hook_is_not_run_for_reports(self):
+        """Hooks are not run by commands that change nothing"""
+        self.add_hook("on-commit-log")
+
+        self.t("export")
+        time.sleep(0.5)
+
+        self.assertFalse(os.path.exists(self.log))
+
+    def test_hooks_are_off_by_default(self):
+        """No hooks run unless 'hooks' is on"""
+        self.t = Timew()
+        self.hooks = os.path.join(self.t.datadir, "hooks")
+        self.log = os.path.join(self.t.datadir, "hooks.log")
+        os.mkdir(self.hooks)
+        self.add_hook("on-commit-log")
+
+        self.t("track FOO 2021-02-01T08:00:00Z - 2021-02-01T09:00:00Z")
+        time.sleep(0.5)
+
+        self.assertFalse(os.path.exists(self.log))
+
+    def test_only_on_commit_scripts_are_hooks(self):
+        """Scripts not named 'on-commit*' are not run"""
+        self.add_hook("other")
+
+        self.t("track FOO 2021-02-01T08:00:00Z - 2021-02-01T09:00:00Z")
+        time.sleep(0.5)
+
+        self.assertFalse(os.path.exists(self.log))
+        self.assertFalse(os.path.exists(os.path.join(self.t.datadir, "spool")))
+
+    def test_failed_hook_is_retried(self):
+        """Commands queued for a failing hook are passed again after the next command"""
+        self.add_hook("on-commit-log", status=1)
+
+        self.t("track FOO 2021-02-01T08:00:00Z - 2021-02-01T09:00:00Z")
+        self.wait_for_log(1)
+        # Let the worker give up before the next one starts.
+        time.sleep(0.5)
+
+        os.remove(self.log)
+        self.add_hook("on-commit-log")
+
+        self.t("track BAR 2021-02-01T10:00:00Z - 2021-02-01T11:00:00Z")
+
+        log = self.wait_for_log(2)
+        self.assertEqual(len(log), 2)
+        self.assertClosedInterval(log[0]["changes"][0]["after"], expectedTags=["FOO"])
+        self.assertClosedInterval(log[1]["changes"][0]["after"], expectedTags=["BAR"])
+
+    def test_failed_hook_does_not_hold_back_others(self):
+        """A failing hook is retried alone, and its batch moved aside after repeated failures"""
+        self.add_hook("on-commit-log")
+        failing = os.path.join(self.hooks, "on-commit-fail")
+        with open(failing, "w") as f:
+            f.write("#!/bin/sh\ncat > /dev/null\nexit 1\n")
+        os.chmod(failing, stat.S_IRWXU)
+
+        spool = os.path.join(self.t.datadir, "spool")
+        for hour in range(6):
+            self.t("track FOO 2021-02-01T{0:02d}:00:00Z - 2021-02-01T{0:02d}:30:00Z".format(hour))
+            self.wait_for_log(hour + 1)
+            # Let the worker finish before the next one starts.
+            time.sleep(0.5)
+
+        log = self.wait_for_log(6)
+        self.assertEqual(len(log), 6)
+        self.assertTrue(os.path.exists(os.path.join(spool, "on-commit-fail.cursor")))
+        self.assertEqual(len(os.listdir(os.path.join(spool, "failed"))), 1)
+
+    def test_hooks_can_be_disabled(self):
+        """No hooks run with 'hooks' off"""
+        self.add_hook("on-commit-log")
+        self.t.config("hooks", "off")
+
+        self.t("track FOO 2021-02-01T08:00:00Z - 2021-02-01T09:00:00Z")
+        time.sleep(0.5)
+
+        self.assertFalse(os.path.exists(self.log))
+
+
+if __name__ == "__main__":
+    from simpletap import TAPTestRunner
+
+    unittest.main(testRunner=TAPTestRunner())
@@ -0,0 +1,78 @@
+////////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included
+// in all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+// OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+// THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// https://www.opensource.org/licenses/mit-license.php
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include <test.h>
+#include <api/libtimew.h>
+
+#include <ScratchDir.h>
+
+////////////////////////////////////////////////////////////////////////////////
+int main ()
+{
+  UnitTest t (17);
+  ScratchDir scratchDir;
+
+  // 2020-01-01T09:00:00Z to 2020-01-01T10:00:00Z.
+  const int64_t start = 1577869200;
+  const int64_t end   = 1577872800;
+
+  t.is (timew_abi_version (), TIMEW_ABI_VERSION, "timew_abi_version");
+
+  timew_session* session {nullptr};
+  t.is (timew_open ("db", 0, &session), TIMEW_ERROR,  "timew_open fails without a database");
+  t.ok (std::string (timew_last_error (session)) != "", "timew_last_error after a failed open");
+  timew_close (session);
+
+  t.is (timew_open ("db", 1, &session), TIMEW_OK,     "timew_open creates a database");
+  t.is (timew_commit (nullptr), TIMEW_INVALID,        "timew_commit without a session");
+
+  const char* tags[] = {"foo", "bar"};
+  t.is (timew_track (session, start, end, tags, 2, "some notes"), TIMEW_OK, "timew_track");
+  t.is (timew_track (session, start, end, tags, 1, nullptr), TIMEW_ERROR,   "timew_track fails on overlap");
+  t.is (timew_commit (session), TIMEW_OK,             "timew_commit");
+
+  timew_intervals* intervals {nullptr};
+  timew_query_t query {0, 0, tags, 1, nullptr};
+  t.is (timew_query (session, &query, &intervals), TIMEW_OK, "timew_query");
+  t.is ((int) timew_count (intervals), 1,             "timew_count");
+
+  timew_interval interval;
+  t.is (timew_next (intervals, &interval), TIMEW_OK,  "timew_next");
+  t.ok (interval.start == start && interval.end == end, "timew_next range");
+  t.is ((int) interval.tag_count, 2,                  "timew_next tag count");
+  t.is (interval.annotation, "some notes",            "timew_next annotation");
+  t.is (timew_next (intervals, &interval), TIMEW_END, "timew_next at the end");
+  timew_release (intervals);
+
+  t.is (timew_active (session, &intervals), TIMEW_OK, "timew_active");
+  t.is ((int) timew_count (intervals), 0,             "timew_active without an open interval");
+  timew_release (intervals);
+  timew_close (session);
+
+  return 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,122 @@
+#!/usr/bin/env python3
+
+###############################################################################
+#
+# Copyright 2016 - 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# https://www.opensource.org/licenses/mit-license.php
+#
+###############################################################################
+
+import os
+import sys
+import unittest
+
+from datetime import datetime, timedelta
+
+# Ensure python finds the local simpletap module
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from basetest import Timew, TestCase
+
+
+
+
+class TestMounts(TestCase):
+    def setUp(self):
+        """Executed before each test in the class"""
+        self.t = Timew()
+        self.other = Timew()
+
+    def test_export_includes_mounted_intervals(self):
+        """Export merges the intervals of mounted databases by date"""
+        self.t("track FOO 2021-02-01T08:00:00Z - 2021-02-01T09:00:00Z")
+        self.t("track FOO 2021-02-01T12:00:00Z - 2021-02-01T13:00:00Z")
+        self.other("track BAR 2021-02-01T10:00:00Z - 2021-02-01T11:00:00Z")
+        self.t.config("mounts", self.other.datadir)
+
+        j = self.t.export()
+
+        self.assertEqual(len(j), 3)
+        self.assertClosedInterval(j[0], expectedId=2, expectedTags=["FOO"])
+        self.assertClosedInterval(j[1], expectedId=1, expectedTags=["BAR"])
+        self.assertClosedInterval(j[2], expectedId=1, expectedTags=["FOO"])
+        self.assertNotIn("source", j[0])
+        self.assertEqual(j[1]["source"], self.other.datadir)
+
+    def test_mount_through_environment(self):
+        """Databases following TIMEWARRIORDB are mounted"""
+        self.other("track BAR 2021-02-01T10:00:00Z - 2021-02-01T11:00:00Z")
+        self.t.env["TIMEWARRIORDB"] = "{}:{}".format(self.t.datadir, self.other.datadir)
+
+        j = self.t.export()
+
+        self.assertEqual(len(j), 1)
+        self.assertEqual(j[0]["source"], self.other.datadir)
+
+    def test_summary_includes_mounted_intervals(self):
+        """Summary totals the intervals of mounted databases"""
+        self.t("track FOO 2021-02-01T08:00:00 - 2021-02-01T09:00:00")
+        self.other("track BAR 2021-02-01T10:00:00 - 2021-02-01T11:30:00")
+        self.t.config("mounts", self.other.datadir)
+
+        code, out, err = self.t("summary 2021-02-01 - 2021-02-02")
+
+        self.assertIn("FOO", out)
+        self.assertIn("BAR", out)
+        self.assertIn("2:30:00", out)
+
+    def test_summary_hierarchy_includes_mounted_tags(self):
+        """Summary hierarchy places mounted tags under their parents"""
+        self.t.config("tags.separator", "/")
+        self.t("track acme 2021-02-01T08:00:00 - 2021-02-01T09:00:00")
+        self.other("track acme/web 2021-02-01T10:00:00 - 2021-02-01T11:00:00")
+        self.t.config("mounts", self.other.datadir)
+
+        code, out, err = self.t("summary 2021-02-01 - 2021-02-02 :hierarchy")
+
+        self.assertRegex(out, "\nacme +2:00:00\n"
+                              "  acme/web +1:00:00\n")
+
+    def test_mounted_intervals_do_not_overlap_tracked_ones(self):
+        """Tracking ignores mounted databases, which are not changed"""
+        self.other("track BAR 2021-02-01T10:00:00Z - 2021-02-01T11:00:00Z")
+        self.t.config("mounts", self.other.datadir)
+
+        self.t("track FOO 2021-02-01T10:00:00Z - 2021-02-01T11:00:00Z")
+
+        j = self.other.export()
+        self.assertEqual(len(j), 1)
+        self.assertClosedInterval(j[0], expectedTags=["BAR"])
+
+    def test_mount_of_missing_database(self):
+        """Mounting a directory without a database fails"""
+        self.t.config("mounts", os.path.join(self.other.datadir, "missing"))
+
+        code, out, err = self.t.runError("export")
+
+        self.assertIn("There is no database at", err)
+
+
+if __name__ == "__main__":
+    from simpletap import TAPTestRunner
+
+    unittest.main(testRunner=TAPTestRunner())
@@ -24,6 +24,15 @@ TIMEW_BIN="${BASH_SOURCE[0]%/*}/../src/timew"
 
 [[ -x "${TIMEW_BIN}" ]] || exit 1
 
+# Drops the data files from the page cache (GNU dd)
+function drop_page_cache()
+{
+  for file in "${TIMEWARRIORDB}"/data/????-??.data ; do
+    [[ -f "${file}" ]] && dd if="${file}" iflag=nocache count=0 2>/dev/null
+  done
+  return 0
+}
+
 function test_performance_annotate()
 {
   # setup
@@ -89,6 +98,26 @@ function test_performance_export()
   ) 2>&1 >/dev/null ) | awk '{a[NR]=$2}; END {for(i=1;i<=3;i++){printf "%s\t",a[i]}}')
 }
 
+function test_performance_export-all-cold()
+{
+  # setup
+  drop_page_cache
+  # test
+  ( ( time -p (
+      ${TIMEW_BIN} export :all >/dev/null
+  ) 2>&1 >/dev/null ) | awk '{a[NR]=$2}; END {for(i=1;i<=3;i++){printf "%s\t",a[i]}}')
+}
+
+function test_performance_export-all-warm()
+{
+  # setup
+  ${TIMEW_BIN} export :all >/dev/null
+  # test
+  ( ( time -p (
+      ${TIMEW_BIN} export :all >/dev/null
+  ) 2>&1 >/dev/null ) | awk '{a[NR]=$2}; END {for(i=1;i<=3;i++){printf "%s\t",a[i]}}')
+}
+
 function test_performance_gaps()
 {
   # test
@@ -244,6 +273,16 @@ function test_performance_summary()
   ) 2>&1 >/dev/null ) | awk '{a[NR]=$2}; END {for(i=1;i<=3;i++){printf "%s\t",a[i]}}')
 }
 
+function test_performance_summary-year-cold()
+{
+  # setup
+  drop_page_cache
+  # test
+  ( ( time -p (
+      ${TIMEW_BIN} summary :year >/dev/null
+  ) 2>&1 >/dev/null ) | awk '{a[NR]=$2}; END {for(i=1;i<=3;i++){printf "%s\t",a[i]}}')
+}
+
 function test_performance_tag()
 {
   # setup
@@ -319,7 +358,7 @@ rm -f ${TIMEWARRIORDB}/data/*.data
 mkdir -p "${OUTPUT_DIR}"
 rm -rf "${OUTPUT_DIR:?}"/*
 
-TIMEW_COMMANDS="annotate cancel continue day delete export gaps get join lengthen modify-end modify-start month move resize shorten split start stop summary tag tags track undo untag week"
+TIMEW_COMMANDS="annotate cancel continue day delete export export-all-cold export-all-warm gaps get join lengthen modify-end modify-start month move resize shorten split start stop summary summary-year-cold tag tags track undo untag week"
 
 # Write headers
 for timew_cmd in ${TIMEW_COMMANDS} ; do
@@ -0,0 +1,91 @@
+#!/usr/bin/env python3
+
+###############################################################################
+#
+# Copyright 2016 - 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# https://www.opensource.org/licenses/mit-license.php
+#
+###############################################################################
+
+import os
+import sys
+import unittest
+
+from datetime import datetime, timedelta
+
+# Ensure python finds the local simpletap module
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from basetest import Timew, TestCase
+
+
+
+class TestPurge(TestCase):
+    def setUp(self):
+        """Executed before each test in the class"""
+        self.t = Timew()
+
+    def test_purge_before_date(self):
+        """Purge removes earlier months and trims the boundary"""
+        self.t("track 2015-12-10T10:00:00Z - 2015-12-10T11:00:00Z foo")
+        self.t("track 2016-01-31T23:00:00Z - 2016-02-01T01:00:00Z foo")
+        self.t("track 2016-02-05T10:00:00Z - 2016-02-05T11:00:00Z bar")
+
+        code, out, err = self.t("purge before:2016-02-01T00:00:00Z :yes")
+
+        self.assertIn('Purged 1 interval before', out)
+        self.assertFalse(os.path.exists(os.path.join(self.t.env["TIMEWARRIORDB"], "data", "2015-12.data")))
+
+        j = self.t.export()
+
+        self.assertEqual(len(j), 2)
+        self.assertClosedInterval(j[0],
+                                  expectedStart="20160201T000000Z",
+                                  expectedEnd="20160201T010000Z",
+                                  expectedTags=["foo"])
+        self.assertClosedInterval(j[1],
+                                  expectedStart="20160205T100000Z",
+                                  expectedEnd="20160205T110000Z",
+                                  expectedTags=["bar"])
+
+    def test_purge_trims_journal(self):
+        """Purge drops journal entries about purged time"""
+        self.t("track 2015-12-10T10:00:00Z - 2015-12-10T11:00:00Z foo")
+        self.t("track 2016-02-05T10:00:00Z - 2016-02-05T11:00:00Z bar")
+
+        self.t("purge before:2016-01-01T00:00:00Z :yes")
+        self.t("undo")
+        self.assertEqual([], self.t.export())
+
+        code, out, err = self.t("undo")
+        self.assertIn('Nothing to undo.', out)
+
+    def test_purge_without_date_fails(self):
+        """Purge requires a date"""
+        code, out, err = self.t.runError("purge :yes")
+        self.assertIn("A date must be specified.", err)
+
+
+if __name__ == "__main__":
+    from simpletap import TAPTestRunner
+
+    unittest.main(testRunner=TAPTestRunner())
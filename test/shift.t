@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+
+###############################################################################
+#
+# Copyright 2016 - 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# https://www.opensource.org/licenses/mit-license.php
+#
+###############################################################################
+
+import os
+import sys
+import unittest
+
+from datetime import datetime, timedelta
+
+# Ensure python finds the local simpletap module
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from basetest import Timew, TestCase
+
+
+
+class TestShift(TestCase):
+    def setUp(self):
+        """Executed before each test in the class"""
+        self.t = Timew()
+
+    def test_shift_range_forwards(self):
+        """Shift all intervals in a range forwards, across a month boundary"""
+        self.t("track 2016-01-31T20:00:00Z - 2016-01-31T21:00:00Z foo")
+        self.t("track 2016-01-31T23:00:00Z - 2016-01-31T23:30:00Z bar")
+
+        code, out, err = self.t("shift 2016-01-31T00:00:00Z - 2016-02-01T00:00:00Z 1h")
+
+        self.assertIn('Shifted 2 intervals by 1:00:00.', out)
+
+        j = self.t.export()
+
+        self.assertEqual(len(j), 2)
+        self.assertClosedInterval(j[0],
+                                  expectedStart="20160131T210000Z",
+                                  expectedEnd="20160131T220000Z",
+                                  expectedTags=["foo"])
+        self.assertClosedInterval(j[1],
+                                  expectedStart="20160201T000000Z",
+                                  expectedEnd="20160201T003000Z",
+                                  expectedTags=["bar"])
+
+    def test_shift_range_back(self):
+        """Shift all intervals in a range back, leaving those outside alone"""
+        self.t("track 2016-01-01T10:00:00Z - 2016-01-01T11:00:00Z foo")
+        self.t("track 2016-01-02T10:00:00Z - 2016-01-02T11:00:00Z bar")
+
+        self.t("shift 2016-01-02T00:00:00Z - 2016-01-03T00:00:00Z back 30min")
+
+        j = self.t.export()
+
+        self.assertEqual(len(j), 2)
+        self.assertClosedInterval(j[0],
+                                  expectedStart="20160101T100000Z",
+                                  expectedEnd="20160101T110000Z",
+                                  expectedTags=["foo"])
+        self.assertClosedInterval(j[1],
+                                  expectedStart="20160102T093000Z",
+                                  expectedEnd="20160102T103000Z",
+                                  expectedTags=["bar"])
+
+    def test_shift_into_other_interval_fails(self):
+        """Shifting onto an interval outside the range is an error"""
+        self.t("track 2016-01-01T10:00:00Z - 2016-01-01T11:00:00Z foo")
+        self.t("track 2016-01-01T12:00:00Z - 2016-01-01T13:00:00Z bar")
+
+        code, out, err = self.t.runError("shift 2016-01-01T09:00:00Z - 2016-01-01T11:30:00Z 90min")
+
+        self.assertIn('Shifting would overlap @1.', err)
+
+    def test_shift_and_undo(self):
+        """Undo a shift in one step"""
+        self.t("track 2016-01-01T10:00:00Z - 2016-01-01T11:00:00Z foo")
+        self.t("track 2016-01-02T10:00:00Z - 2016-01-02T11:00:00Z bar")
+        before = self.t.export()
+
+        self.t("shift 2016-01-01T00:00:00Z - 2016-01-03T00:00:00Z 1h")
+        self.t("undo")
+
+        self.assertEqual(before, self.t.export())
+
+
+if __name__ == "__main__":
+    from simpletap import TAPTestRunner
+
+    unittest.main(testRunner=TAPTestRunner())
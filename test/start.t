@@ -76,6 +76,21 @@ class TestStart(TestCase):
 
         self.assertIn("Time tracking cannot be set in the future.", err)
 
+    def test_start_and_stop_with_fixed_clock(self):
+        """Test start and stop relative to a fixed current time"""
+        self.t.config("debug.now", "2020-01-01T12:00:00Z")
+
+        self.t("start 1h ago FOO")
+        self.t("stop")
+
+        j = self.t.export()
+
+        self.assertEqual(len(j), 1)
+        self.assertClosedInterval(j[0],
+                                  expectedStart="20200101T110000Z",
+                                  expectedEnd="20200101T120000Z",
+                                  expectedTags=["FOO"])
+
     def test_start_with_open_interval(self):
         """Test start with already open interval, which should be auto-stopped"""
         self.t("start 2016-01-01T00:00:00 foo")
@@ -0,0 +1,94 @@
+#!/usr/bin/env python3
+
+###############################################################################
+#
+# Copyright 2016 - 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# https://www.opensource.org/licenses/mit-license.php
+#
+###############################################################################
+
+import json
+import os
+import sys
+import unittest
+
+from datetime import datetime, timedelta
+
+# Ensure python finds the local simpletap module
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from basetest import Timew, TestCase
+
+
+
+
+class TestStats(TestCase):
+    def setUp(self):
+        """Executed before each test in the class"""
+        self.t = Timew()
+
+    def test_stats_of_empty_database(self):
+        """Stats of an empty database are all zero"""
+        code, out, err = self.t("stats :json")
+
+        j = json.loads(out)
+        self.assertEqual(j["months"], [])
+        self.assertEqual(j["intervals"], 0)
+        self.assertEqual(j["journal"]["transactions"], 0)
+
+    def test_stats_per_month(self):
+        """Stats count the intervals, open intervals and tags of each month"""
+        self.t("track FOO BAR 2021-01-01T08:00:00Z - 2021-01-01T09:00:00Z")
+        self.t("track FOO 2021-02-01T08:00:00Z - 2021-02-01T09:00:00Z")
+        self.t("start BAZ 2021-02-02T08:00:00Z")
+
+        code, out, err = self.t("stats :json")
+
+        j = json.loads(out)
+        self.assertEqual([m["month"] for m in j["months"]], ["2021-01", "2021-02"])
+        self.assertEqual(j["months"][0]["intervals"], 1)
+        self.assertEqual(j["months"][0]["tags"], 2)
+        self.assertEqual(j["months"][1]["intervals"], 2)
+        self.assertEqual(j["months"][1]["open"], 1)
+        self.assertEqual(j["intervals"], 3)
+        self.assertEqual(j["open"], 1)
+        self.assertEqual(j["tags"], 3)
+        self.assertEqual(j["journal"]["transactions"], 3)
+
+        size = os.path.getsize(os.path.join(self.t.datadir, "data", "2021-02.data"))
+        self.assertEqual(j["months"][1]["bytes"], size)
+
+    def test_stats_as_text(self):
+        """Stats are shown as a table with totals"""
+        self.t("track FOO 2021-02-01T08:00:00Z - 2021-02-01T09:00:00Z")
+
+        code, out, err = self.t("stats")
+
+        self.assertIn("2021-02", out)
+        self.assertIn("Intervals: 1, 0 open", out)
+        self.assertIn("Journal:", out)
+
+
+if __name__ == "__main__":
+    from simpletap import TAPTestRunner
+
+    unittest.main(testRunner=TAPTestRunner())
@@ -47,6 +47,15 @@ class TestSummary(TestCase):
         code, out, err = self.t("summary")
         self.assertIn("No filtered data found in the range", out)
 
+    def test_summary_of_the_day_of_a_fixed_clock(self):
+        """Without a range, the summary is that of the day of the current time"""
+        self.t.config("debug.now", "2016-05-27T23:00:00")
+        self.t("track 20160527T080000 - 20160527T100000 foo")
+
+        code, out, err = self.t("summary")
+        self.assertIn("foo", out)
+        self.assertIn("2:00:00", out)
+
     def test_filled(self):
         """Summary should be printed if data is available"""
         now = datetime.now()
@@ -340,6 +349,33 @@ W10 2017-03-11 Sat @3 FOO  10:00:00 11:00:00 1:00:00
                                                      6:00:00
 """, out)
 
+    def test_with_hierarchy_hint(self):
+        """Summary with :hierarchy hint should display totals per tag hierarchy"""
+        self.t("track 2017-03-09T08:00:00 - 2017-03-09T09:00:00 acme.web.api")
+        self.t("track 2017-03-09T09:00:00 - 2017-03-09T10:00:00 acme.web")
+        self.t("track 2017-03-09T10:00:00 - 2017-03-09T11:00:00 acme.app other")
+        self.t("track 2017-03-09T11:00:00 - 2017-03-09T12:00:00 other")
+
+        code, out, err = self.t("summary 2017-03-09 - 2017-03-10 :hierarchy")
+
+        self.assertRegex(out, "\nacme +3:00:00\n"
+                              "  acme.app +1:00:00\n"
+                              "  acme.web +2:00:00\n"
+                              "    acme.web.api +1:00:00\n"
+                              "other +2:00:00\n")
+
+    def test_with_hierarchy_hint_and_custom_separator(self):
+        """Summary with :hierarchy hint should use the configured separator"""
+        self.t.config("tags.separator", "/")
+        self.t("track 2017-03-09T08:00:00 - 2017-03-09T09:00:00 acme/web")
+        self.t("track 2017-03-09T09:00:00 - 2017-03-09T10:00:00 acme.app")
+
+        code, out, err = self.t("summary 2017-03-09 - 2017-03-10 :hierarchy")
+
+        self.assertRegex(out, "\nacme +1:00:00\n"
+                              "  acme/web +1:00:00\n"
+                              "acme.app +1:00:00\n")
+
     def test_with_empty_interval_at_start_of_day(self):
         """Summary should display empty intervals at midnight"""
         self.t("track sod - sod")
@@ -0,0 +1,135 @@
+#!/usr/bin/env python3
+
+###############################################################################
+#
+# Copyright 2016 - 2021, Thomas Lauf, Paul Beckingham, Federico Hernandez.
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included
+# in all copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+# OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+# THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# https://www.opensource.org/licenses/mit-license.php
+#
+###############################################################################
+
+import os
+import sys
+import unittest
+
+from datetime import datetime, timedelta
+
+# Ensure python finds the local simpletap module
+sys.path.append(os.path.dirname(os.path.abspath(__file__)))
+
+from basetest import Timew, TestCase
+
+
+
+
+class TestSync(TestCase):
+    def setUp(self):
+        """Executed before each test in the class"""
+        self.t = Timew()
+        self.other = Timew()
+
+    def sync(self):
+        return self.t("sync {}".format(self.other.datadir))
+
+    def test_sync_copies_to_empty_database(self):
+        """Sync copies all intervals to an empty database"""
+        self.t("track FOO 2021-01-01T08:00:00Z - 2021-01-01T09:00:00Z")
+        self.t("track BAR 2021-02-01T08:00:00Z - 2021-02-01T09:00:00Z")
+
+        code, out, err = self.sync()
+        self.assertIn("2 months copied, 0 merged.", out)
+
+        j = self.other.export()
+        self.assertEqual(len(j), 2)
+        self.assertClosedInterval(j[0], expectedStart="20210101T080000Z", expectedTags=["FOO"])
+        self.assertClosedInterval(j[1], expectedStart="20210201T080000Z", expectedTags=["BAR"])
+
+    def test_sync_copies_changes_back(self):
+        """Sync copies changes made in the other database"""
+        self.t("track FOO 2021-01-01T08:00:00Z - 2021-01-01T09:00:00Z")
+        self.sync()
+
+        self.other("track BAR 2021-02-01T08:00:00Z - 2021-02-01T09:00:00Z")
+        self.other("tag @2 BAZ")
+
+        self.sync()
+
+        j = self.t.export()
+        self.assertEqual(len(j), 2)
+        self.assertClosedInterval(j[0], expectedTags=["BAZ", "FOO"])
+        self.assertClosedInterval(j[1], expectedTags=["BAR"])
+
+    def test_sync_merges_changes_to_one_month(self):
+        """Sync merges changes to the same month from both databases"""
+        self.t("track FOO 2021-02-01T08:00:00Z - 2021-02-01T09:00:00Z")
+        self.t("track BAR 2021-02-01T10:00:00Z - 2021-02-01T11:00:00Z")
+        self.sync()
+
+        self.t("track BAZ 2021-02-01T12:00:00Z - 2021-02-01T13:00:00Z")
+        self.other("delete @2")
+
+        code, out, err = self.sync()
+        self.assertIn("0 months copied, 1 merged.", out)
+
+        for db in (self.t, self.other):
+            j = db.export()
+            self.assertEqual(len(j), 2)
+            self.assertClosedInterval(j[0], expectedTags=["BAR"])
+            self.assertClosedInterval(j[1], expectedTags=["BAZ"])
+
+    def test_sync_reports_conflicts(self):
+        """Sync leaves a month where both databases changed the same time"""
+        self.t("track FOO 2021-02-01T08:00:00Z - 2021-02-01T09:00:00Z")
+        self.sync()
+
+        self.t("modify end @1 2021-02-01T09:30:00Z")
+        self.other("modify end @1 2021-02-01T09:15:00Z")
+
+        code, out, err = self.t.runError("sync {}".format(self.other.datadir))
+        self.assertIn("Both databases changed the same time in 2021-02, which was not synced.", out)
+
+        self.assertClosedInterval(self.t.export()[0], expectedEnd="20210201T093000Z")
+        self.assertClosedInterval(self.other.export()[0], expectedEnd="20210201T091500Z")
+
+    def test_sync_can_be_undone(self):
+        """Undo reverts the changes sync made to this database"""
+        self.t("track FOO 2021-01-01T08:00:00Z - 2021-01-01T09:00:00Z")
+        self.other("track BAR 2021-02-01T08:00:00Z - 2021-02-01T09:00:00Z")
+        self.sync()
+
+        self.assertEqual(len(self.t.export()), 2)
+
+        self.t("undo")
+
+        j = self.t.export()
+        self.assertEqual(len(j), 1)
+        self.assertClosedInterval(j[0], expectedTags=["FOO"])
+
+    def test_sync_with_itself(self):
+        """Sync refuses to sync a database with itself"""
+        code, out, err = self.t.runError("sync {}".format(self.t.datadir))
+        self.assertIn("A database cannot be synced with itself.", err)
+
+
+if __name__ == "__main__":
+    from simpletap import TAPTestRunner
+
+    unittest.main(testRunner=TAPTestRunner())
@@ -73,6 +73,77 @@ class TestTags(TestCase):
         self.assertNotIn('foo', out)
         self.assertIn('bar', out)
 
+    def test_tags_rename(self):
+        """Test renaming a tag in all intervals, and undoing it"""
+        self.t("track 20160101T0100 - 20160101T1000 foo")
+        self.t("track 20160201T0100 - 20160201T1000 foo bar")
+        self.t("track 20160301T0100 - 20160301T1000 bar")
+
+        code, out, err = self.t("tags rename foo baz")
+        self.assertIn('Renamed tags in 2 intervals.', out)
+
+        j = self.t.export()
+        self.assertEqual(j[0]['tags'], ['baz'])
+        self.assertEqual(j[1]['tags'], ['bar', 'baz'])
+        self.assertEqual(j[2]['tags'], ['bar'])
+
+        self.t("undo")
+        j = self.t.export()
+        self.assertEqual(j[0]['tags'], ['foo'])
+        self.assertEqual(j[1]['tags'], ['bar', 'foo'])
+
+    def test_tags_rename_back(self):
+        """Test renaming a tag and back again changes the tracked intervals"""
+        self.t("track 20160101T0100 - 20160101T1000 foo")
+
+        self.t("tags rename foo baz")
+        j = self.t.export()
+        self.assertEqual(len(j), 1)
+        self.assertEqual(j[0]['tags'], ['baz'])
+
+        code, out, err = self.t("tags rename baz foo")
+        self.assertIn('Renamed tags in 1 interval.', out)
+
+        j = self.t.export()
+        self.assertEqual(j[0]['tags'], ['foo'])
+
+    def test_tags_rename_to_used_tag(self):
+        """Test renaming a tag to a tag in use merges them, and undoing it"""
+        self.t("track 20160101T0100 - 20160101T1000 foo bar")
+        self.t("track 20160201T0100 - 20160201T1000 bar")
+
+        code, out, err = self.t("tags rename foo bar")
+        self.assertIn('Renamed tags in 1 interval.', out)
+
+        j = self.t.export()
+        self.assertEqual(j[0]['tags'], ['bar'])
+        self.assertEqual(j[1]['tags'], ['bar'])
+
+        self.t("undo")
+        j = self.t.export()
+        self.assertEqual(j[0]['tags'], ['bar', 'foo'])
+        self.assertEqual(j[1]['tags'], ['bar'])
+
+    def test_tags_merge(self):
+        """Test merging tags into one, and undoing it"""
+        self.t("track 20160101T0100 - 20160101T1000 foo")
+        self.t("track 20160201T0100 - 20160201T1000 foo bar")
+        self.t("track 20160301T0100 - 20160301T1000 baz")
+
+        code, out, err = self.t("tags merge foo baz bar")
+        self.assertIn('Merged tags in 3 intervals.', out)
+
+        j = self.t.export()
+        self.assertEqual(j[0]['tags'], ['bar'])
+        self.assertEqual(j[1]['tags'], ['bar'])
+        self.assertEqual(j[2]['tags'], ['bar'])
+
+        self.t("undo")
+        j = self.t.export()
+        self.assertEqual(j[0]['tags'], ['foo'])
+        self.assertEqual(j[1]['tags'], ['bar', 'foo'])
+        self.assertEqual(j[2]['tags'], ['baz'])
+
 
 class TestTagFeedback(TestCase):
     def setUp(self):
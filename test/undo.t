@@ -717,6 +717,38 @@ class TestUndo(TestCase):
         self.assertEqual(after_config, self.t("config"))
         self.assertEqual(after_c, self.t.export())
 
+    def test_undo_several_transactions(self):
+        """Test undo of several transactions in one call"""
+
+        self.t("start 16h ago proja")
+        before_b = self.t.export()
+        self.t("start 15h ago projb")
+        self.t("tag @1 foo")
+        self.t("start 14h ago projc")
+        self.t("undo 3")
+        self.assertEqual(before_b, self.t.export())
+        self.t("undo 5")
+        self.assertEqual([], self.t.export())
+
+    def test_undo_coalesced_tracking(self):
+        """Test undo of tracking commands coalesced in the journal"""
+
+        self.t.config("journal.coalesce", "60")
+        self.t("start 1h ago foo")
+        self.t("stop")
+        self.t("start bar")
+        self.t("undo")
+        self.assertEqual([], self.t.export())
+
+    def test_undo_with_invalid_count(self):
+        """Test undo with a count that is not a positive number"""
+
+        self.t("start 16h ago proja")
+        before = self.t.export()
+        self.t.runError("undo 0")
+        self.t.runError("undo foo")
+        self.assertEqual(before, self.t.export())
+
 if __name__ == "__main__":
     from simpletap import TAPTestRunner
 
@@ -31,7 +31,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 int main (int, char**)
 {
-  UnitTest t (7 + 6 + 6 + 6);
+  UnitTest t (7 + 6 + 6 + 6 + 3);
 
   // std::string escape (const std::string& input, int c)
   t.is (escape ("", 'x'),    "",        "escape '','x' --> ''");
@@ -97,6 +97,11 @@ int main (int, char**)
     t.is (joined.length (), (size_t) 13,  "join '' - 'a' - 'bc' - 'def' -> length 9");
     t.is (joined,           "-a-bc-\"d e f\"", "join '' - 'a' - 'bc' - 'def' -> '-a-bc-\"d e f\"'");
   }
+
+  // std::string contentHash (const std::string& content)
+  t.is (contentHash (""),  "cbf29ce484222325", "contentHash '' --> 'cbf29ce484222325'");
+  t.is (contentHash ("a"), "af63dc4c8601ec8c", "contentHash 'a' --> 'af63dc4c8601ec8c'");
+  t.notok (contentHash ("ab") == contentHash ("ba"), "contentHash 'ab' != contentHash 'ba'");
   return 0;
 }
 